@@ -0,0 +1,525 @@
+#pragma once
+// BinaryLog.h
+#ifndef BINARY_LOG_H
+#define BINARY_LOG_H
+
+#include <cstdint>
+#include <cstring>
+#include <cstdio>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <fstream>
+#include <chrono>
+#include <ctime>
+#include <filesystem>
+#include <algorithm>
+#include <functional>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/file.h>
+#endif
+
+// ===== Event Types =====
+enum class LogEvent : uint16_t {
+    Message = 0,
+    SystemStarted,
+    SystemClosed,
+    TakeAwayPlaced,
+    DineInPlaced,
+    TakeAwayServed,
+    DineInServed,
+    Search,
+    Rollover,
+    OrderCancelled,
+    OrderModified,
+    Count
+};
+
+inline const char* logEventName(LogEvent e) {
+    static const char* names[] = {
+        "Message", "SystemStarted", "SystemClosed", "TakeAwayPlaced", "DineInPlaced",
+        "TakeAwayServed", "DineInServed", "Search", "Rollover",
+        "OrderCancelled", "OrderModified"
+    };
+    auto i = static_cast<size_t>(e);
+    return i < static_cast<size_t>(LogEvent::Count) ? names[i] : "Unknown";
+}
+
+inline bool parseLogEvent(const std::string& name, LogEvent& out) {
+    for (uint16_t i = 0; i < static_cast<uint16_t>(LogEvent::Count); ++i) {
+        if (name == logEventName(static_cast<LogEvent>(i))) {
+            out = static_cast<LogEvent>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+// ===== On-Disk Layout =====
+// A segment is a 32-byte header followed by records. Raw segments (.rlog) store
+// each record as a fixed 32-byte block plus textLen bytes of text, so a scan can
+// filter on time and type without touching the text. Packed segments (.rlogz)
+// store the same records delta/varint encoded.
+struct LogRecord {
+    uint64_t timestampUs = 0;   // microseconds since the Unix epoch
+    uint16_t type = 0;          // LogEvent
+    uint16_t textLen = 0;
+    uint16_t branch = 0;
+    uint16_t item = 0;          // menu index
+    uint32_t orderId = 0;
+    int32_t quantity = 0;
+    int64_t amount = 0;         // paisa (1/100 Rs)
+};
+static_assert(sizeof(LogRecord) == 32, "LogRecord must stay 32 bytes on disk");
+
+struct LogSegmentHeader {
+    char magic[4] = { 'R', 'L', 'O', 'G' };
+    uint16_t version = 1;
+    uint16_t flags = 0;         // bit 0: packed
+    uint16_t branch = 0;
+    uint16_t reserved = 0;
+    uint32_t recordCount = 0;   // 0 with lastUs == 0 means the segment was never sealed
+    uint64_t firstUs = 0;
+    uint64_t lastUs = 0;
+};
+static_assert(sizeof(LogSegmentHeader) == 32, "LogSegmentHeader must stay 32 bytes on disk");
+
+const uint16_t LOG_SEGMENT_PACKED = 1;
+const size_t LOG_MAX_TEXT = 0xFFFF;
+
+inline uint64_t logNowUs() {
+    using namespace std::chrono;
+    return duration_cast<microseconds>(system_clock::now().time_since_epoch()).count();
+}
+
+inline int64_t toPaisa(double rupees) {
+    return static_cast<int64_t>(rupees * 100.0 + (rupees < 0 ? -0.5 : 0.5));
+}
+
+// ===== Varint Codec (packed segments) =====
+namespace logcodec {
+    inline void putVarint(std::vector<char>& out, uint64_t v) {
+        while (v >= 0x80) {
+            out.push_back(static_cast<char>((v & 0x7F) | 0x80));
+            v >>= 7;
+        }
+        out.push_back(static_cast<char>(v));
+    }
+
+    inline bool getVarint(const char*& p, const char* end, uint64_t& v) {
+        v = 0;
+        for (int shift = 0; p < end && shift < 64; shift += 7) {
+            uint8_t b = static_cast<uint8_t>(*p++);
+            v |= static_cast<uint64_t>(b & 0x7F) << shift;
+            if (!(b & 0x80)) return true;
+        }
+        return false;
+    }
+
+    inline uint64_t zigzag(int64_t v) { return (static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63); }
+    inline int64_t unzigzag(uint64_t v) { return static_cast<int64_t>(v >> 1) ^ -static_cast<int64_t>(v & 1); }
+}
+
+// ===== Segment Naming =====
+struct LogSegmentInfo {
+    std::string path;
+    uint32_t sequence = 0;
+    bool packed = false;
+};
+
+// Segments are named <prefix>-NNNNNN.rlog / <prefix>-NNNNNN.rlogz, oldest first.
+inline std::vector<LogSegmentInfo> listLogSegments(const std::string& dir, const std::string& prefix) {
+    namespace fs = std::filesystem;
+    std::vector<LogSegmentInfo> out;
+    std::error_code ec;
+    for (const auto& entry : fs::directory_iterator(dir.empty() ? "." : dir, ec)) {
+        if (!entry.is_regular_file(ec)) continue;
+        std::string file = entry.path().filename().string();
+        std::string ext = entry.path().extension().string();
+        if (ext != ".rlog" && ext != ".rlogz") continue;
+        if (file.size() < prefix.size() + 1 || file.compare(0, prefix.size() + 1, prefix + "-") != 0) continue;
+        std::string digits = file.substr(prefix.size() + 1, file.size() - prefix.size() - 1 - ext.size());
+        if (digits.empty() || !std::all_of(digits.begin(), digits.end(), [](char c) { return c >= '0' && c <= '9'; })) continue;
+        out.push_back({ entry.path().string(), static_cast<uint32_t>(std::stoul(digits)), ext == ".rlogz" });
+    }
+    std::sort(out.begin(), out.end(), [](const LogSegmentInfo& a, const LogSegmentInfo& b) {
+        return a.sequence < b.sequence;
+    });
+    return out;
+}
+
+// ===== Segment Ownership =====
+// A live writer holds an exclusive advisory lock on its open segment for as
+// long as it writes to it, so another process can tell a crashed writer's
+// segment from one that is still being written.
+class SegmentLock {
+#ifdef _WIN32
+    HANDLE handle = INVALID_HANDLE_VALUE;
+
+    // Locks one byte far past any real data; Windows locks are mandatory and
+    // would otherwise block the writer's own stream.
+    bool lock(DWORD flags) {
+        OVERLAPPED at{};
+        at.OffsetHigh = 0x7FFFFFFF;
+        if (LockFileEx(handle, flags, 0, 1, 0, &at)) return true;
+        release();
+        return false;
+    }
+    bool open(const std::string& path, DWORD disposition) {
+        handle = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE,
+            FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, disposition, FILE_ATTRIBUTE_NORMAL, nullptr);
+        return handle != INVALID_HANDLE_VALUE;
+    }
+public:
+    bool create(const std::string& path) { return open(path, CREATE_NEW) && lock(LOCKFILE_EXCLUSIVE_LOCK); }
+    bool tryAcquire(const std::string& path) {
+        return open(path, OPEN_EXISTING) && lock(LOCKFILE_EXCLUSIVE_LOCK | LOCKFILE_FAIL_IMMEDIATELY);
+    }
+    void release() {
+        if (handle != INVALID_HANDLE_VALUE) CloseHandle(handle);
+        handle = INVALID_HANDLE_VALUE;
+    }
+#else
+    int fd = -1;
+
+    bool lock(int op) {
+        if (flock(fd, op) == 0) return true;
+        release();
+        return false;
+    }
+public:
+    bool create(const std::string& path) {
+        fd = ::open(path.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+        return fd >= 0 && lock(LOCK_EX);
+    }
+    bool tryAcquire(const std::string& path) {
+        fd = ::open(path.c_str(), O_RDWR);
+        return fd >= 0 && lock(LOCK_EX | LOCK_NB);
+    }
+    void release() {
+        if (fd >= 0) ::close(fd);
+        fd = -1;
+    }
+#endif
+    SegmentLock() = default;
+    SegmentLock(const SegmentLock&) = delete;
+    SegmentLock& operator=(const SegmentLock&) = delete;
+    ~SegmentLock() { release(); }
+};
+
+// ===== Writer =====
+struct BinaryLogConfig {
+    std::string directory = ".";
+    std::string prefix = "log";
+    uint16_t branch = 0;
+    uint64_t maxSegmentBytes = 8ull << 20;
+    uint64_t maxSegmentSeconds = 24 * 60 * 60;
+    bool compressClosed = false;
+    bool flushEachRecord = true;
+    // Without per-record flushes, records reach the file at least this often
+    // (or when the stream buffer fills, or on flush() and rotation).
+    uint64_t flushIntervalUs = 1000000;
+};
+
+class BinaryLogWriter {
+    BinaryLogConfig config;
+    std::ofstream file;
+    SegmentLock owner;
+    std::string currentPath;
+    LogSegmentHeader header;
+    uint32_t sequence = 0;
+    uint64_t bytesWritten = 0;
+    uint64_t openedUs = 0;
+    uint64_t flushedUs = 0;
+
+    std::string segmentPath(uint32_t seq, bool packed) const {
+        char name[32];
+        std::snprintf(name, sizeof(name), "-%06u.rlog%s", seq, packed ? "z" : "");
+        return (std::filesystem::path(config.directory) / (config.prefix + name)).string();
+    }
+
+    // Claims the next free sequence number. Segments are created exclusively,
+    // so writers sharing a prefix (or a packed segment of that number) are
+    // never truncated; a taken number is skipped.
+    void openSegment() {
+        namespace fs = std::filesystem;
+        for (;;) {
+            ++sequence;
+            currentPath = segmentPath(sequence, false);
+            if (!owner.create(currentPath)) {
+                if (fs::exists(currentPath)) continue;
+                break;  // unwritable directory: the stream below fails the same way
+            }
+            std::error_code ec;
+            if (!fs::exists(segmentPath(sequence, true), ec)) break;
+            owner.release();
+            fs::remove(currentPath, ec);
+        }
+        header = LogSegmentHeader();
+        header.branch = config.branch;
+        file.open(currentPath, std::ios::binary);
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        bytesWritten = sizeof(header);
+        flushedUs = openedUs = logNowUs();
+    }
+
+    void sealSegment() {
+        if (!file.is_open()) return;
+        file.seekp(0);
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.close();
+        std::error_code ec;
+        if (header.recordCount == 0) std::filesystem::remove(currentPath, ec);
+        else if (config.compressClosed) packSegment(currentPath, segmentPath(sequence, true));
+        owner.release();
+    }
+
+    bool needsRotation(uint64_t nowUs, size_t incoming) const {
+        if (header.recordCount == 0) return false;
+        if (bytesWritten + incoming > config.maxSegmentBytes) return true;
+        return config.maxSegmentSeconds && nowUs - openedUs >= config.maxSegmentSeconds * 1000000ull;
+    }
+
+public:
+    explicit BinaryLogWriter(BinaryLogConfig cfg = BinaryLogConfig()) : config(std::move(cfg)) {
+        // Only segments nobody holds are crash debris; live writers keep theirs.
+        auto existing = listLogSegments(config.directory, config.prefix);
+        for (const auto& seg : existing) {
+            SegmentLock orphan;
+            if (seg.packed || !orphan.tryAcquire(seg.path) || !recoverSegment(seg.path)) continue;
+            if (config.compressClosed)
+                packSegment(seg.path, segmentPath(seg.sequence, true));
+        }
+        if (!existing.empty()) sequence = existing.back().sequence;
+        openSegment();
+    }
+
+    void write(LogRecord rec, std::string_view text) {
+        if (text.size() > LOG_MAX_TEXT) text = text.substr(0, LOG_MAX_TEXT);
+        rec.textLen = static_cast<uint16_t>(text.size());
+        rec.branch = config.branch;
+        if (!rec.timestampUs) rec.timestampUs = logNowUs();
+
+        size_t incoming = sizeof(rec) + text.size();
+        if (needsRotation(rec.timestampUs, incoming)) rotate();
+
+        file.write(reinterpret_cast<const char*>(&rec), sizeof(rec));
+        file.write(text.data(), text.size());
+        if (config.flushEachRecord || rec.timestampUs - flushedUs >= config.flushIntervalUs) {
+            file.flush();
+            flushedUs = rec.timestampUs;
+        }
+        bytesWritten += incoming;
+
+        if (!header.recordCount) header.firstUs = rec.timestampUs;
+        header.lastUs = rec.timestampUs;
+        ++header.recordCount;
+    }
+
+    void rotate() {
+        sealSegment();
+        openSegment();
+    }
+
+    void flush() {
+        file.flush();
+        flushedUs = logNowUs();
+    }
+
+    const std::string& path() const { return currentPath; }
+
+    // Seals a raw segment left open by a crash: rebuilds the header from its
+    // records and drops a torn trailing record; one with no records is removed.
+    // Returns true when the file is a sealed raw segment ready to be packed.
+    static bool recoverSegment(const std::string& rawPath) {
+        std::ifstream in(rawPath, std::ios::binary);
+        std::vector<char> raw((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        in.close();
+        LogSegmentHeader hdr;
+        if (raw.size() < sizeof(hdr)) return false;
+        std::memcpy(&hdr, raw.data(), sizeof(hdr));
+        if (std::memcmp(hdr.magic, "RLOG", 4) != 0 || (hdr.flags & LOG_SEGMENT_PACKED)) return false;
+        if (hdr.lastUs != 0) return true;
+
+        const char* begin = raw.data() + sizeof(hdr);
+        const char* p = begin;
+        const char* end = raw.data() + raw.size();
+        while (end - p >= static_cast<ptrdiff_t>(sizeof(LogRecord))) {
+            LogRecord rec;
+            std::memcpy(&rec, p, sizeof(rec));
+            if (end - p < static_cast<ptrdiff_t>(sizeof(rec) + rec.textLen)) break;
+            if (!hdr.recordCount) hdr.firstUs = rec.timestampUs;
+            hdr.lastUs = rec.timestampUs;
+            ++hdr.recordCount;
+            p += sizeof(rec) + rec.textLen;
+        }
+
+        std::error_code ec;
+        if (!hdr.recordCount) {
+            std::filesystem::remove(rawPath, ec);
+            return false;
+        }
+        if (p != end) std::filesystem::resize_file(rawPath, static_cast<uintmax_t>(p - raw.data()), ec);
+        std::fstream out(rawPath, std::ios::binary | std::ios::in | std::ios::out);
+        out.write(reinterpret_cast<const char*>(&hdr), sizeof(hdr));
+        return out.good();
+    }
+
+    // Rewrites a sealed raw segment as a packed one and removes the original.
+    static bool packSegment(const std::string& rawPath, const std::string& packedPath) {
+        std::ifstream in(rawPath, std::ios::binary);
+        std::vector<char> raw((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        in.close();
+        if (raw.size() < sizeof(LogSegmentHeader)) return false;
+
+        LogSegmentHeader hdr;
+        std::memcpy(&hdr, raw.data(), sizeof(hdr));
+        hdr.flags |= LOG_SEGMENT_PACKED;
+
+        std::vector<char> out(sizeof(hdr));
+        out.reserve(raw.size() / 2);
+        uint64_t prevUs = hdr.firstUs;
+        const char* p = raw.data() + sizeof(hdr);
+        const char* end = raw.data() + raw.size();
+        while (end - p >= static_cast<ptrdiff_t>(sizeof(LogRecord))) {
+            LogRecord rec;
+            std::memcpy(&rec, p, sizeof(rec));
+            if (end - p < static_cast<ptrdiff_t>(sizeof(rec) + rec.textLen)) break;
+            const char* text = p + sizeof(rec);
+            p += sizeof(rec) + rec.textLen;
+
+            logcodec::putVarint(out, logcodec::zigzag(static_cast<int64_t>(rec.timestampUs - prevUs)));
+            logcodec::putVarint(out, rec.type);
+            logcodec::putVarint(out, rec.branch);
+            logcodec::putVarint(out, rec.item);
+            logcodec::putVarint(out, rec.orderId);
+            logcodec::putVarint(out, logcodec::zigzag(rec.quantity));
+            logcodec::putVarint(out, logcodec::zigzag(rec.amount));
+            logcodec::putVarint(out, rec.textLen);
+            out.insert(out.end(), text, text + rec.textLen);
+            prevUs = rec.timestampUs;
+        }
+        std::memcpy(out.data(), &hdr, sizeof(hdr));
+
+        std::string tmpPath = packedPath + ".tmp";
+        {
+            std::ofstream o(tmpPath, std::ios::binary | std::ios::trunc);
+            o.write(out.data(), out.size());
+            if (!o) return false;
+        }
+        std::error_code ec;
+        std::filesystem::rename(tmpPath, packedPath, ec);
+        if (ec) return false;
+        std::filesystem::remove(rawPath, ec);
+        return true;
+    }
+
+    ~BinaryLogWriter() { sealSegment(); }
+};
+
+// ===== Reader =====
+struct LogFilter {
+    uint64_t fromUs = 0;
+    uint64_t toUs = UINT64_MAX;
+    uint64_t typeMask = ~0ull;  // bit per LogEvent
+    int branch = -1;
+
+    bool matches(const LogRecord& r) const {
+        return r.timestampUs >= fromUs && r.timestampUs <= toUs
+            && (typeMask >> (r.type & 63) & 1)
+            && (branch < 0 || r.branch == branch);
+    }
+};
+
+using LogVisitor = std::function<void(const LogRecord&, std::string_view)>;
+
+// Decodes one segment; returns the number of matching records. Sealed segments
+// whose time range lies outside the filter are skipped after reading the header.
+inline size_t readLogSegment(const std::string& path, const LogFilter& filter, const LogVisitor& visit) {
+    std::ifstream in(path, std::ios::binary);
+    LogSegmentHeader hdr;
+    if (!in.read(reinterpret_cast<char*>(&hdr), sizeof(hdr)) || std::memcmp(hdr.magic, "RLOG", 4) != 0)
+        return 0;
+    bool sealed = hdr.lastUs != 0;
+    if (sealed && (hdr.lastUs < filter.fromUs || hdr.firstUs > filter.toUs)) return 0;
+
+    in.seekg(0, std::ios::end);
+    std::streamoff size = in.tellg();
+    std::vector<char> buf(static_cast<size_t>(std::max<std::streamoff>(0, size - static_cast<std::streamoff>(sizeof(hdr)))));
+    in.seekg(sizeof(hdr));
+    in.read(buf.data(), buf.size());
+
+    size_t matched = 0;
+    const char* p = buf.data();
+    const char* end = p + buf.size();
+
+    if (!(hdr.flags & LOG_SEGMENT_PACKED)) {
+        while (end - p >= static_cast<ptrdiff_t>(sizeof(LogRecord))) {
+            LogRecord rec;
+            std::memcpy(&rec, p, sizeof(rec));
+            if (end - p < static_cast<ptrdiff_t>(sizeof(rec) + rec.textLen)) break;
+            if (filter.matches(rec)) {
+                visit(rec, std::string_view(p + sizeof(rec), rec.textLen));
+                ++matched;
+            }
+            p += sizeof(rec) + rec.textLen;
+        }
+        return matched;
+    }
+
+    uint64_t prevUs = hdr.firstUs;
+    while (p < end) {
+        uint64_t delta, type, branch, item, orderId, qty, amount, len;
+        if (!logcodec::getVarint(p, end, delta) || !logcodec::getVarint(p, end, type)
+            || !logcodec::getVarint(p, end, branch) || !logcodec::getVarint(p, end, item)
+            || !logcodec::getVarint(p, end, orderId) || !logcodec::getVarint(p, end, qty)
+            || !logcodec::getVarint(p, end, amount) || !logcodec::getVarint(p, end, len)
+            || static_cast<uint64_t>(end - p) < len)
+            break;
+        LogRecord rec;
+        rec.timestampUs = prevUs + logcodec::unzigzag(delta);
+        rec.type = static_cast<uint16_t>(type);
+        rec.branch = static_cast<uint16_t>(branch);
+        rec.item = static_cast<uint16_t>(item);
+        rec.orderId = static_cast<uint32_t>(orderId);
+        rec.quantity = static_cast<int32_t>(logcodec::unzigzag(qty));
+        rec.amount = logcodec::unzigzag(amount);
+        rec.textLen = static_cast<uint16_t>(len);
+        prevUs = rec.timestampUs;
+        if (filter.matches(rec)) {
+            visit(rec, std::string_view(p, len));
+            ++matched;
+        }
+        p += len;
+    }
+    return matched;
+}
+
+inline std::string formatLogRecord(const LogRecord& r, std::string_view text) {
+    std::time_t secs = static_cast<std::time_t>(r.timestampUs / 1000000);
+    std::tm tm{};
+#ifdef _WIN32
+    localtime_s(&tm, &secs);
+#else
+    localtime_r(&secs, &tm);
+#endif
+    char when[32];
+    std::strftime(when, sizeof(when), "%Y-%m-%d %H:%M:%S", &tm);
+
+    unsigned long long paisa = static_cast<unsigned long long>(r.amount < 0 ? -r.amount : r.amount);
+    char line[160];
+    std::snprintf(line, sizeof(line), "%s.%06llu [%s] branch=%u order=%u item=%u qty=%d amount=%s%llu.%02llu ",
+        when, static_cast<unsigned long long>(r.timestampUs % 1000000), logEventName(static_cast<LogEvent>(r.type)),
+        r.branch, r.orderId, r.item, r.quantity, r.amount < 0 ? "-" : "", paisa / 100, paisa % 100);
+    return std::string(line).append(text);
+}
+
+#endif
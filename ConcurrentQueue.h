@@ -0,0 +1,76 @@
+#pragma once
+// ConcurrentQueue.h
+#ifndef CONCURRENT_QUEUE_H
+#define CONCURRENT_QUEUE_H
+
+#include <atomic>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <stdexcept>
+
+// Bounded multi-producer / multi-consumer ring (Vyukov). Each cell carries a
+// sequence number telling producers and consumers whose turn it is, so push and
+// pop are a single CAS on the shared index and never block.
+template <typename T>
+class BoundedQueue {
+    struct Cell {
+        std::atomic<size_t> sequence;
+        T value;
+    };
+
+    std::vector<Cell> cells;
+    size_t mask;
+    alignas(64) std::atomic<size_t> enqueuePos{ 0 };
+    alignas(64) std::atomic<size_t> dequeuePos{ 0 };
+
+public:
+    explicit BoundedQueue(size_t capacity) : cells(capacity), mask(capacity - 1) {
+        if (capacity < 2 || (capacity & mask) != 0)
+            throw std::invalid_argument("BoundedQueue capacity must be a power of two");
+        for (size_t i = 0; i < capacity; ++i)
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    BoundedQueue(const BoundedQueue&) = delete;
+    BoundedQueue& operator=(const BoundedQueue&) = delete;
+
+    bool tryPush(T&& value) {
+        size_t pos = enqueuePos.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell& cell = cells[pos & mask];
+            size_t seq = cell.sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    cell.value = std::move(value);
+                    cell.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (diff < 0) return false;
+            else pos = enqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+
+    bool tryPop(T& out) {
+        size_t pos = dequeuePos.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell& cell = cells[pos & mask];
+            size_t seq = cell.sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+            if (diff == 0) {
+                if (dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    out = std::move(cell.value);
+                    cell.sequence.store(pos + mask + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (diff < 0) return false;
+            else pos = dequeuePos.load(std::memory_order_relaxed);
+        }
+    }
+};
+
+#endif
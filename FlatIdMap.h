@@ -0,0 +1,77 @@
+#pragma once
+// FlatIdMap.h
+#ifndef FLAT_ID_MAP_H
+#define FLAT_ID_MAP_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+// Open-addressed map from non-zero 32-bit ids to small values. Linear probing
+// with backward-shift deletion keeps the table free of tombstones, and the
+// table only grows with the peak number of live ids, never per insert.
+template <typename V>
+class FlatIdMap {
+    struct Entry {
+        uint32_t key = 0;
+        V value{};
+    };
+
+    std::vector<Entry> table;
+    size_t count = 0;
+
+    size_t mask() const { return table.size() - 1; }
+    static size_t hash(uint32_t key) { return static_cast<size_t>(key * 2654435761u); }
+
+    void grow() {
+        std::vector<Entry> old;
+        old.swap(table);
+        table.assign(old.empty() ? 64 : old.size() * 2, Entry());
+        count = 0;
+        for (auto& e : old)
+            if (e.key) insert(e.key, e.value);
+    }
+
+public:
+    V* find(uint32_t key) {
+        if (!key || table.empty()) return nullptr;
+        for (size_t i = hash(key) & mask();; i = (i + 1) & mask()) {
+            if (table[i].key == key) return &table[i].value;
+            if (!table[i].key) return nullptr;
+        }
+    }
+
+    void insert(uint32_t key, V value) {
+        if ((count + 1) * 2 > table.size()) grow();
+        size_t i = hash(key) & mask();
+        while (table[i].key && table[i].key != key) i = (i + 1) & mask();
+        if (!table[i].key) ++count;
+        table[i].key = key;
+        table[i].value = value;
+    }
+
+    bool erase(uint32_t key) {
+        if (!key || table.empty()) return false;
+        size_t i = hash(key) & mask();
+        while (table[i].key != key) {
+            if (!table[i].key) return false;
+            i = (i + 1) & mask();
+        }
+        // Pull back any later entry of the same probe run whose home slot is
+        // not between the hole and itself.
+        for (size_t j = (i + 1) & mask(); table[j].key; j = (j + 1) & mask()) {
+            size_t home = hash(table[j].key) & mask();
+            if (((j - home) & mask()) >= ((j - i) & mask())) {
+                table[i] = table[j];
+                i = j;
+            }
+        }
+        table[i] = Entry();
+        --count;
+        return true;
+    }
+
+    size_t size() const { return count; }
+};
+
+#endif
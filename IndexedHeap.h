@@ -0,0 +1,79 @@
+#pragma once
+// IndexedHeap.h
+#ifndef INDEXED_HEAP_H
+#define INDEXED_HEAP_H
+
+#include <vector>
+#include <cstddef>
+
+// Binary heap of node pointers where every node records its own position
+// (through the Slot member), so any node can be removed or re-sifted in
+// O(log n) without searching. Before(a, b) is true when a must come out first.
+// One node can sit in several heaps as long as each uses a different Slot.
+template <typename T, size_t T::*Slot, typename Before>
+class IndexedHeap {
+    std::vector<T*> items;
+    Before before;
+
+    void place(size_t i, T* node) {
+        items[i] = node;
+        node->*Slot = i;
+    }
+
+    void siftUp(size_t i) {
+        T* node = items[i];
+        while (i > 0 && before(node, items[(i - 1) / 2])) {
+            place(i, items[(i - 1) / 2]);
+            i = (i - 1) / 2;
+        }
+        place(i, node);
+    }
+
+    void siftDown(size_t i) {
+        T* node = items[i];
+        size_t n = items.size();
+        for (;;) {
+            size_t child = 2 * i + 1;
+            if (child >= n) break;
+            if (child + 1 < n && before(items[child + 1], items[child])) ++child;
+            if (!before(items[child], node)) break;
+            place(i, items[child]);
+            i = child;
+        }
+        place(i, node);
+    }
+
+public:
+    bool empty() const { return items.empty(); }
+    size_t size() const { return items.size(); }
+    T* top() const { return items.front(); }
+    const std::vector<T*>& nodes() const { return items; }
+
+    void push(T* node) {
+        items.push_back(node);
+        siftUp(items.size() - 1);
+    }
+
+    void remove(T* node) {
+        size_t i = node->*Slot;
+        T* last = items.back();
+        items.pop_back();
+        if (last == node) return;
+        place(i, last);
+        update(last);
+    }
+
+    // Restores order after the node's key changed.
+    void update(T* node) {
+        siftUp(node->*Slot);
+        siftDown(node->*Slot);
+    }
+
+    // Restores order after every key changed.
+    void rebuild() {
+        for (size_t i = 0; i < items.size(); ++i) items[i]->*Slot = i;
+        for (size_t i = items.size() / 2; i-- > 0;) siftDown(i);
+    }
+};
+
+#endif
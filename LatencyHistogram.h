@@ -0,0 +1,63 @@
+#pragma once
+// LatencyHistogram.h
+#ifndef LATENCY_HISTOGRAM_H
+#define LATENCY_HISTOGRAM_H
+
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+
+// Fixed-size log-linear histogram of durations in milliseconds: exact below 32 ms,
+// then 32 sub-buckets per power of two (about 3% relative error). Recording
+// never allocates, so it can sit on the serving path.
+class LatencyHistogram {
+    static const int SUB_BITS = 5;
+    static const int SUB = 1 << SUB_BITS;
+    static const int GROUPS = 64 - SUB_BITS;
+
+    uint64_t counts[(GROUPS + 1) * SUB] = {};
+    uint64_t total = 0;
+    uint64_t maxValue = 0;
+
+    static size_t bucketOf(uint64_t v) {
+        if (v < static_cast<uint64_t>(SUB)) return static_cast<size_t>(v);
+        int msb = 63;
+        while (!(v >> msb & 1)) --msb;
+        int group = msb - SUB_BITS + 1;
+        size_t sub = static_cast<size_t>(v >> (group - 1)) & (SUB - 1);
+        return static_cast<size_t>(group) * SUB + sub;
+    }
+
+    static uint64_t upperBound(size_t bucket) {
+        if (bucket < static_cast<size_t>(SUB)) return bucket;
+        int group = static_cast<int>(bucket / SUB);
+        uint64_t sub = bucket % SUB;
+        return ((SUB + sub + 1) << (group - 1)) - 1;
+    }
+
+public:
+    void record(uint64_t ms) {
+        ++counts[bucketOf(ms)];
+        ++total;
+        maxValue = std::max(maxValue, ms);
+    }
+
+    // Smallest recorded bucket bound covering fraction q (0..1) of samples.
+    uint64_t percentile(double q) const {
+        if (!total) return 0;
+        uint64_t rank = static_cast<uint64_t>(q * total + 0.5);
+        rank = std::max<uint64_t>(1, std::min(rank, total));
+        uint64_t seen = 0;
+        for (size_t b = 0; b < sizeof(counts) / sizeof(counts[0]); ++b) {
+            seen += counts[b];
+            if (seen >= rank) return std::min(upperBound(b), maxValue);
+        }
+        return maxValue;
+    }
+
+    uint64_t count() const { return total; }
+    uint64_t max() const { return maxValue; }
+    void clear() { *this = LatencyHistogram(); }
+};
+
+#endif
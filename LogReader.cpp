@@ -0,0 +1,98 @@
+// LogReader.cpp
+// Companion tool for the binary log written by Logger: decodes raw and packed
+// segments, filters by time range / event type / branch and exports text.
+//
+//   LogReader [--dir D] [--prefix P] [--from T] [--to T] [--type A,B] [--branch N] [--count] [--out FILE]
+//
+// T is either Unix seconds or local "YYYY-MM-DD[THH:MM[:SS]]".
+#include <iostream>
+#include <sstream>
+#include <iomanip>
+#include "BinaryLog.h"
+
+using namespace std;
+
+static bool parseTime(const string& s, uint64_t& us) {
+    if (!s.empty() && all_of(s.begin(), s.end(), [](char c) { return c >= '0' && c <= '9'; })) {
+        us = stoull(s) * 1000000ull;
+        return true;
+    }
+    tm tm{};
+    string text = s;
+    replace(text.begin(), text.end(), 'T', ' ');
+    const char* formats[] = { "%Y-%m-%d %H:%M:%S", "%Y-%m-%d %H:%M", "%Y-%m-%d" };
+    for (auto f : formats) {
+        tm = {};
+        istringstream in(text);
+        in >> get_time(&tm, f);
+        if (!in.fail()) {
+            tm.tm_isdst = -1;
+            time_t t = mktime(&tm);
+            if (t < 0) return false;
+            us = static_cast<uint64_t>(t) * 1000000ull;
+            return true;
+        }
+    }
+    return false;
+}
+
+static void usage() {
+    cerr << "Usage: LogReader [--dir D] [--prefix P] [--from T] [--to T] [--type A,B] [--branch N] [--count] [--out FILE]\n"
+        << "Event types:";
+    for (uint16_t i = 0; i < static_cast<uint16_t>(LogEvent::Count); ++i)
+        cerr << ' ' << logEventName(static_cast<LogEvent>(i));
+    cerr << endl;
+}
+
+int main(int argc, char** argv) {
+    string dir = ".", prefix = "log", outPath;
+    LogFilter filter;
+    bool countOnly = false;
+
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--dir" && hasValue) dir = argv[++i];
+        else if (arg == "--prefix" && hasValue) prefix = argv[++i];
+        else if (arg == "--out" && hasValue) outPath = argv[++i];
+        else if (arg == "--branch" && hasValue) filter.branch = stoi(argv[++i]);
+        else if (arg == "--count") countOnly = true;
+        else if ((arg == "--from" || arg == "--to") && hasValue) {
+            uint64_t us;
+            if (!parseTime(argv[++i], us)) { cerr << "Bad time: " << argv[i] << endl; return 1; }
+            if (arg == "--from") filter.fromUs = us;
+            else filter.toUs = us;
+        }
+        else if (arg == "--type" && hasValue) {
+            filter.typeMask = 0;
+            stringstream names(argv[++i]);
+            string name;
+            while (getline(names, name, ',')) {
+                LogEvent e;
+                if (!parseLogEvent(name, e)) { cerr << "Unknown event type: " << name << endl; usage(); return 1; }
+                filter.typeMask |= 1ull << static_cast<uint16_t>(e);
+            }
+        }
+        else { usage(); return arg == "--help" ? 0 : 1; }
+    }
+
+    ofstream file;
+    if (!outPath.empty()) {
+        file.open(outPath);
+        if (!file) { cerr << "Cannot open " << outPath << endl; return 1; }
+    }
+    ostream& out = outPath.empty() ? cout : file;
+
+    size_t total = 0;
+    string line;
+    for (const auto& seg : listLogSegments(dir, prefix)) {
+        total += readLogSegment(seg.path, filter, [&](const LogRecord& r, string_view text) {
+            if (countOnly) return;
+            line = formatLogRecord(r, text);
+            line += '\n';
+            out.write(line.data(), line.size());
+        });
+    }
+    if (countOnly) out << total << endl;
+    return 0;
+}
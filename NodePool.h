@@ -0,0 +1,83 @@
+#pragma once
+// NodePool.h
+#ifndef NODE_POOL_H
+#define NODE_POOL_H
+
+#include <vector>
+#include <memory>
+#include <new>
+#include <utility>
+#include <algorithm>
+
+// Fixed-size node allocator for the order lists and the served tree. Nodes are
+// carved out of geometrically growing chunks and recycled through a free list,
+// so a steady stream of orders stops touching the heap once the pool is warm.
+template <typename T>
+class NodePool {
+    union Slot {
+        Slot* next;
+        alignas(T) unsigned char storage[sizeof(T)];
+    };
+
+    std::vector<std::unique_ptr<Slot[]>> chunks;
+    Slot* freeList = nullptr;
+    size_t nextChunk = 32;
+    size_t live = 0;
+
+    static const size_t MAX_CHUNK = 4096;
+
+    void grow() {
+        std::unique_ptr<Slot[]> chunk(new Slot[nextChunk]);
+        for (size_t i = 0; i < nextChunk; ++i) {
+            chunk[i].next = freeList;
+            freeList = &chunk[i];
+        }
+        chunks.push_back(std::move(chunk));
+        nextChunk = std::min(nextChunk * 2, MAX_CHUNK);
+    }
+
+public:
+    NodePool() = default;
+    NodePool(const NodePool&) = delete;
+    NodePool& operator=(const NodePool&) = delete;
+
+    template <typename... Args>
+    T* create(Args&&... args) {
+        if (!freeList) grow();
+        Slot* s = freeList;
+        Slot* next = s->next;
+        T* node;
+        try {
+            node = new (s->storage) T(std::forward<Args>(args)...);
+        }
+        catch (...) {
+            s->next = next;
+            throw;
+        }
+        freeList = next;
+        ++live;
+        return node;
+    }
+
+    void destroy(T* node) {
+        if (!node) return;
+        node->~T();
+        Slot* s = reinterpret_cast<Slot*>(node);
+        s->next = freeList;
+        freeList = s;
+        --live;
+    }
+
+    size_t size() const { return live; }
+
+    // Returns every chunk to the heap; only valid once all nodes are destroyed.
+    void release() {
+        if (live) return;
+        chunks.clear();
+        chunks.shrink_to_fit();
+        freeList = nullptr;
+        nextChunk = 32;
+    }
+};
+
+#endif
@@ -0,0 +1,335 @@
+#pragma once
+// PricingEngine.h
+#ifndef PRICING_ENGINE_H
+#define PRICING_ENGINE_H
+
+#include <vector>
+#include <string>
+#include <sstream>
+#include <istream>
+#include <stdexcept>
+#include <algorithm>
+#include <climits>
+#include <cstdint>
+#include <ctime>
+
+enum class OrderType : uint8_t { TakeAway = 0, DineIn = 1 };
+
+inline const char* orderTypeName(OrderType t) {
+    return t == OrderType::DineIn ? "DineIn" : "TakeAway";
+}
+
+// ===== Billing Strategy (rule based) =====
+// A rule matches on age bracket, order type, item, quantity tier and time of day,
+// and adjusts the line total by a percentage and/or a flat per-order amount.
+// Ranges are inclusive except the time window, which is [from, to) in minutes
+// and wraps past midnight when from > to.
+struct PricingRule {
+    std::string name;
+    int minAge = 0, maxAge = INT_MAX;
+    uint8_t typeMask = 0x3;     // bit per OrderType
+    int item = 0;               // menu index, 0 = any
+    int minQty = 1, maxQty = INT_MAX;
+    int fromMinute = 0, toMinute = 24 * 60;
+    double percent = 0;
+    double flat = 0;
+
+    bool matches(int age, OrderType type, int itemIndex, int qty, int minute) const {
+        if (age < minAge || age > maxAge) return false;
+        if (!(typeMask >> static_cast<int>(type) & 1)) return false;
+        if (item && item != itemIndex) return false;
+        if (qty < minQty || qty > maxQty) return false;
+        return inWindow(minute);
+    }
+
+    bool inWindow(int minute) const {
+        if (fromMinute <= toMinute) return minute >= fromMinute && minute < toMinute;
+        return minute >= fromMinute || minute < toMinute;
+    }
+};
+
+// Column-wise batch of orders, one entry per order.
+struct OrderBatch {
+    std::vector<int> item, qty, age, minute;
+    std::vector<OrderType> type;
+
+    void add(int itemIndex, int quantity, int customerAge, OrderType orderType, int minuteOfDay) {
+        item.push_back(itemIndex);
+        qty.push_back(quantity);
+        age.push_back(customerAge);
+        type.push_back(orderType);
+        minute.push_back(minuteOfDay);
+    }
+    size_t size() const { return item.size(); }
+    void clear() { item.clear(); qty.clear(); age.clear(); minute.clear(); type.clear(); }
+};
+
+inline int currentMinuteOfDay() {
+    std::time_t now = std::time(nullptr);
+    std::tm tm{};
+#ifdef _WIN32
+    localtime_s(&tm, &now);
+#else
+    localtime_r(&now, &tm);
+#endif
+    return tm.tm_hour * 60 + tm.tm_min;
+}
+
+// Rules are compiled into a flat table: every dimension is cut at the rule
+// boundaries, a value finds its bucket by bisecting that dimension's sorted
+// cuts (at most two per rule, so memory never depends on how large a boundary
+// is), and every combination of buckets stores the combined multiplier and
+// flat amount. Pricing an order is four short bisections and two array loads.
+// The table has one cell per bucket combination, so it grows with the product
+// of the distinct boundaries per dimension. Past MAX_CELLS (a few dozen rules
+// with unrelated age/qty/time ranges) the engine keeps one rule bitset per
+// bucket and dimension instead; an order then costs one AND per 64 rules plus
+// the rules that match.
+class PricingEngine {
+    std::vector<int> basePrices;
+    std::vector<PricingRule> rules;
+
+    std::vector<int> ageCuts{ 0 }, qtyCuts{ 0 }, itemCuts{ 0 }, minuteCuts{ 0 };
+    size_t nAge = 1, nQty = 1, nItem = 1, nMinute = 1;
+    std::vector<double> multiplier, addend;
+
+    bool flatTable = true;
+    size_t ruleWords = 0;
+    std::vector<uint64_t> ageRules, typeRules, itemRules, qtyRules, minuteRules;
+
+    static const size_t MAX_CELLS = 1u << 22;
+
+    // Sorted lower bounds of a dimension's buckets; the first is always 0 and
+    // negative values fall into it.
+    static std::vector<int> sortedCuts(std::vector<int> cuts) {
+        cuts.erase(std::remove_if(cuts.begin(), cuts.end(), [](int c) { return c <= 0; }), cuts.end());
+        cuts.push_back(0);
+        std::sort(cuts.begin(), cuts.end());
+        cuts.erase(std::unique(cuts.begin(), cuts.end()), cuts.end());
+        return cuts;
+    }
+
+    static size_t bucketOf(int v, const std::vector<int>& cuts) {
+        auto it = std::upper_bound(cuts.begin(), cuts.end(), v);
+        return it == cuts.begin() ? 0 : static_cast<size_t>(it - cuts.begin()) - 1;
+    }
+
+    size_t cellOf(int item, int qty, int age, OrderType type, int minute) const {
+        size_t c = bucketOf(age, ageCuts);
+        c = c * 2 + static_cast<size_t>(type);
+        c = c * nItem + bucketOf(item, itemCuts);
+        c = c * nQty + bucketOf(qty, qtyCuts);
+        c = c * nMinute + bucketOf(minute, minuteCuts);
+        return c;
+    }
+
+    // Combined multiplier and flat amount of every rule matching the order.
+    void adjustment(int item, int qty, int age, OrderType type, int minute, double& mul, double& add) const {
+        if (flatTable) {
+            size_t c = cellOf(item, qty, age, type, minute);
+            mul = multiplier[c];
+            add = addend[c];
+            return;
+        }
+        const uint64_t* a = &ageRules[bucketOf(age, ageCuts) * ruleWords];
+        const uint64_t* t = &typeRules[static_cast<size_t>(type) * ruleWords];
+        const uint64_t* i = &itemRules[bucketOf(item, itemCuts) * ruleWords];
+        const uint64_t* q = &qtyRules[bucketOf(qty, qtyCuts) * ruleWords];
+        const uint64_t* m = &minuteRules[bucketOf(minute, minuteCuts) * ruleWords];
+        mul = 1.0;
+        add = 0.0;
+        for (size_t w = 0; w < ruleWords; ++w) {
+            uint64_t hits = a[w] & t[w] & i[w] & q[w] & m[w];
+            for (; hits; hits &= hits - 1) {
+                size_t bit = 0;
+                while (!(hits >> bit & 1)) ++bit;
+                const PricingRule& r = rules[w * 64 + bit];
+                mul *= 1.0 + r.percent / 100.0;
+                add += r.flat;
+            }
+        }
+    }
+
+    // One bitset per bucket of a dimension: bit r is set when rule r accepts
+    // that bucket's representative value.
+    template <typename Accepts>
+    std::vector<uint64_t> ruleMasks(const std::vector<int>& rep, Accepts accepts) const {
+        std::vector<uint64_t> masks(rep.size() * ruleWords, 0);
+        for (size_t b = 0; b < rep.size(); ++b)
+            for (size_t r = 0; r < rules.size(); ++r)
+                if (accepts(rules[r], rep[b])) masks[b * ruleWords + r / 64] |= uint64_t(1) << (r % 64);
+        return masks;
+    }
+
+    double basePrice(int item) const {
+        return item >= 0 && item < static_cast<int>(basePrices.size()) ? basePrices[item] : 0.0;
+    }
+
+public:
+    void setBasePrices(const std::vector<int>& prices) { basePrices = prices; }
+    void setRules(std::vector<PricingRule> r) { rules = std::move(r); }
+    const std::vector<PricingRule>& getRules() const { return rules; }
+    // False once the rule set outgrew MAX_CELLS and uses the bitset fallback.
+    bool usesFlatTable() const { return flatTable; }
+
+    void compile() {
+        std::vector<int> age, qty, item, minute;
+        for (const auto& r : rules) {
+            age.push_back(r.minAge);
+            if (r.maxAge < INT_MAX) age.push_back(r.maxAge + 1);
+            qty.push_back(r.minQty);
+            if (r.maxQty < INT_MAX) qty.push_back(r.maxQty + 1);
+            item.push_back(r.item);
+            if (r.item && r.item < INT_MAX) item.push_back(r.item + 1);
+            minute.push_back(r.fromMinute % (24 * 60));
+            minute.push_back(r.toMinute % (24 * 60));
+        }
+        ageCuts = sortedCuts(age);
+        qtyCuts = sortedCuts(qty);
+        itemCuts = sortedCuts(item);
+        minuteCuts = sortedCuts(minute);
+        nAge = ageCuts.size();
+        nQty = qtyCuts.size();
+        nItem = itemCuts.size();
+        nMinute = minuteCuts.size();
+
+        // Each bucket is represented by its lower bound.
+        const std::vector<int>& ageRep = ageCuts, & qtyRep = qtyCuts, & itemRep = itemCuts, & minuteRep = minuteCuts;
+
+        size_t cells = nAge * 2 * nItem * nQty * nMinute;
+        flatTable = cells <= MAX_CELLS;
+        if (!flatTable) {
+            multiplier.clear();
+            addend.clear();
+            ruleWords = (rules.size() + 63) / 64;
+            ageRules = ruleMasks(ageRep, [](const PricingRule& r, int v) { return v >= r.minAge && v <= r.maxAge; });
+            typeRules = ruleMasks({ 0, 1 }, [](const PricingRule& r, int v) { return (r.typeMask >> v & 1) != 0; });
+            itemRules = ruleMasks(itemRep, [](const PricingRule& r, int v) { return !r.item || r.item == v; });
+            qtyRules = ruleMasks(qtyRep, [](const PricingRule& r, int v) { return v >= r.minQty && v <= r.maxQty; });
+            minuteRules = ruleMasks(minuteRep, [](const PricingRule& r, int v) { return r.inWindow(v); });
+            return;
+        }
+
+        multiplier.assign(cells, 1.0);
+        addend.assign(cells, 0.0);
+        for (size_t a = 0; a < nAge; ++a)
+            for (int t = 0; t < 2; ++t)
+                for (size_t i = 0; i < nItem; ++i)
+                    for (size_t q = 0; q < nQty; ++q)
+                        for (size_t m = 0; m < nMinute; ++m) {
+                            size_t c = cellOf(itemRep[i], qtyRep[q], ageRep[a], static_cast<OrderType>(t), minuteRep[m]);
+                            for (const auto& r : rules) {
+                                if (!r.matches(ageRep[a], static_cast<OrderType>(t), itemRep[i], qtyRep[q], minuteRep[m]))
+                                    continue;
+                                multiplier[c] *= 1.0 + r.percent / 100.0;
+                                addend[c] += r.flat;
+                            }
+                        }
+    }
+
+    double price(int item, int qty, int age, OrderType type, int minute) const {
+        double mul, add;
+        adjustment(item, qty, age, type, minute, mul, add);
+        return std::max(0.0, basePrice(item) * qty * mul + add);
+    }
+
+    // Prices the whole batch into out[0..size). The table lookups run first so
+    // the arithmetic pass is a straight loop over contiguous arrays.
+    void priceBatch(const OrderBatch& batch, std::vector<double>& out) const {
+        size_t n = batch.size();
+        std::vector<double> base(n), mul(n), add(n);
+        for (size_t k = 0; k < n; ++k) {
+            adjustment(batch.item[k], batch.qty[k], batch.age[k], batch.type[k], batch.minute[k], mul[k], add[k]);
+            base[k] = basePrice(batch.item[k]) * batch.qty[k];
+        }
+        out.resize(n);
+        double* o = out.data();
+        const double* b = base.data();
+        const double* m = mul.data();
+        const double* a = add.data();
+        for (size_t k = 0; k < n; ++k) {
+            double v = b[k] * m[k] + a[k];
+            o[k] = v > 0.0 ? v : 0.0;
+        }
+    }
+};
+
+// ===== Rule Configuration =====
+// One rule per line: a name followed by key=value fields, e.g.
+//   senior-discount   age=60-   pct=-10
+//   dinein-surcharge  type=DineIn pct=5
+//   bulk-burger       item=1 qty=10- pct=-15
+//   late-night        time=22:00-02:00 flat=50
+// Ranges accept open ends ("60-", "-12"). Lines starting with '#' are ignored.
+inline void parsePricingRange(const std::string& v, int& lo, int& hi) {
+    size_t dash = v.find('-');
+    if (dash == std::string::npos) { lo = hi = std::stoi(v); return; }
+    if (dash > 0) lo = std::stoi(v.substr(0, dash));
+    if (dash + 1 < v.size()) hi = std::stoi(v.substr(dash + 1));
+}
+
+inline int parsePricingClock(const std::string& v) {
+    size_t colon = v.find(':');
+    int h = std::stoi(v.substr(0, colon));
+    int m = colon == std::string::npos ? 0 : std::stoi(v.substr(colon + 1));
+    return h * 60 + m;
+}
+
+inline std::vector<PricingRule> loadPricingRules(std::istream& in) {
+    std::vector<PricingRule> rules;
+    std::string line;
+    int lineNo = 0;
+    while (std::getline(in, line)) {
+        ++lineNo;
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        std::istringstream fields(line);
+        PricingRule r;
+        if (!(fields >> r.name) || r.name[0] == '#') continue;
+        std::string field;
+        try {
+            while (fields >> field) {
+                size_t eq = field.find('=');
+                if (eq == std::string::npos) throw std::invalid_argument(field);
+                std::string key = field.substr(0, eq), value = field.substr(eq + 1);
+                if (key == "age") parsePricingRange(value, r.minAge, r.maxAge);
+                else if (key == "qty") parsePricingRange(value, r.minQty, r.maxQty);
+                else if (key == "item") r.item = value == "*" ? 0 : std::stoi(value);
+                else if (key == "pct") r.percent = std::stod(value);
+                else if (key == "flat") r.flat = std::stod(value);
+                else if (key == "type") {
+                    if (value == "TakeAway") r.typeMask = 1 << static_cast<int>(OrderType::TakeAway);
+                    else if (value == "DineIn") r.typeMask = 1 << static_cast<int>(OrderType::DineIn);
+                    else throw std::invalid_argument(value);
+                }
+                else if (key == "time") {
+                    size_t dash = value.find('-');
+                    if (dash == std::string::npos) throw std::invalid_argument(value);
+                    r.fromMinute = parsePricingClock(value.substr(0, dash));
+                    r.toMinute = parsePricingClock(value.substr(dash + 1));
+                }
+                else throw std::invalid_argument(key);
+            }
+        }
+        catch (const std::exception&) {
+            throw std::runtime_error("Bad pricing rule at line " + std::to_string(lineNo) + ": " + field);
+        }
+        rules.push_back(r);
+    }
+    return rules;
+}
+
+inline std::vector<PricingRule> defaultPricingRules() {
+    PricingRule senior;
+    senior.name = "senior-discount";
+    senior.minAge = 60;
+    senior.percent = -10;
+
+    PricingRule dineIn;
+    dineIn.name = "dinein-surcharge";
+    dineIn.typeMask = 1 << static_cast<int>(OrderType::DineIn);
+    dineIn.percent = 5;
+
+    return { senior, dineIn };
+}
+
+#endif
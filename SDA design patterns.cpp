@@ -8,6 +8,27 @@
 #include <algorithm>
 #include <chrono>
 #include <thread>
+#include <atomic>
+#include <cstdlib>
+#include <memory>
+#include <iomanip>
+#include <cmath>
+#include <random>
+#include <sstream>
+#include <array>
+#include <variant>
+#include <cctype>
+#include <limits>
+#include <climits>
+#include "BinaryLog.h"
+#include "PricingEngine.h"
+#include "NodePool.h"
+#include "ServedArchive.h"
+#include "ConcurrentQueue.h"
+#include "ThreadAffinity.h"
+#include "FlatIdMap.h"
+#include "IndexedHeap.h"
+#include "LatencyHistogram.h"
 
 
 #define RESET   "\033[0m"
@@ -20,48 +41,83 @@
 using namespace std;
 
 // ===== Logger (Singleton Pattern) =====
+// One instance per branch, each writing its own segments ("log-*" for branch 0,
+// "branchN-*" otherwise). An instance is only written by its branch's thread.
+// Measurement runs get named scratch instances so their synthetic orders never
+// reach a branch's log.
 class Logger {
 private:
-    static Logger* instance;
+    static vector<Logger*> instances;
+    static vector<Logger*> scratch;
     static mutex mtx;
-    ofstream file;
-    Logger() { file.open("log.txt", ios::app); }
+    string prefix;
+    BinaryLogWriter writer;
+    Logger(uint16_t branch, string name) : prefix(move(name)), writer(config(branch, prefix)) {}
+    static BinaryLogConfig config(uint16_t branch, const string& prefix) {
+        BinaryLogConfig cfg;
+        cfg.prefix = prefix;
+        cfg.branch = branch;
+        cfg.maxSegmentBytes = 4ull << 20;
+        cfg.maxSegmentSeconds = 24 * 60 * 60;
+        cfg.compressClosed = true;
+        // Branch shards write at benchmark rates and flush when they go idle.
+        cfg.flushEachRecord = branch == 0;
+        return cfg;
+    }
 public:
-    static Logger& getInstance() {
+    static Logger& getInstance(uint16_t branch = 0) {
+        lock_guard<mutex> lock(mtx);
+        if (instances.size() <= branch) instances.resize(branch + 1, nullptr);
+        if (!instances[branch]) instances[branch] = new Logger(branch, branch ? "branch" + to_string(branch) : "log");
+        return *instances[branch];
+    }
+    static Logger& getScratch(const string& name) {
+        lock_guard<mutex> lock(mtx);
+        for (auto* instance : scratch)
+            if (instance->prefix == name) return *instance;
+        scratch.push_back(new Logger(0, name));
+        return *scratch.back();
+    }
+    static void shutdown() {
         lock_guard<mutex> lock(mtx);
-        if (!instance) instance = new Logger();
-        return *instance;
+        for (auto*& instance : instances) {
+            delete instance;
+            instance = nullptr;
+        }
+        for (auto* instance : scratch) delete instance;
+        scratch.clear();
+    }
+    void log(LogEvent type, string_view text = {}, int item = 0, int qty = 0, double amount = 0, uint32_t orderId = 0) {
+        LogRecord rec;
+        rec.type = static_cast<uint16_t>(type);
+        rec.item = static_cast<uint16_t>(item);
+        rec.quantity = qty;
+        rec.amount = toPaisa(amount);
+        rec.orderId = orderId;
+        writer.write(rec, text);
     }
-    void log(const string& msg) { file << "[LOG] " << msg << endl; }
-    ~Logger() { file.close(); }
+    void log(const string& msg) { log(LogEvent::Message, msg); }
+    void flush() { writer.flush(); }
 };
-Logger* Logger::instance = nullptr;
+vector<Logger*> Logger::instances;
+vector<Logger*> Logger::scratch;
 mutex Logger::mtx;
 
-// ===== User Type (Strategy Pattern) =====
-class UserStrategy {
-public:
-    virtual void accessDashboard() = 0;
-    virtual ~UserStrategy() = default;
+// ===== User Roles =====
+// A role is a type, not an object: its permissions are compile-time constants
+// and the command dispatch table is generated once per role (see Commands).
+struct AdminRole {
+    static constexpr const char* dashboard = "\n[Admin Dashboard] Full access granted.\n";
+    static constexpr bool canMutate = true;
 };
 
-class AdminStrategy : public UserStrategy {
-public:
-    void accessDashboard() override { cout << "\n[Admin Dashboard] Full access granted.\n"; }
+struct GuestRole {
+    static constexpr const char* dashboard = "\n[Guest Dashboard] Menu access only.\n";
+    static constexpr bool canMutate = false;
 };
 
-class GuestStrategy : public UserStrategy {
-public:
-    void accessDashboard() override { cout << "\n[Guest Dashboard] Menu access only.\n"; }
-};
-
-class User {
-    UserStrategy* strategy = nullptr;
-public:
-    void setStrategy(UserStrategy* s) { delete strategy; strategy = s; }
-    void accessDashboard() { if (strategy) strategy->accessDashboard(); }
-    ~User() { delete strategy; }
-};
+// Chosen once at login; visiting it selects the role-specialised command loop.
+using Session = variant<AdminRole, GuestRole>;
 
 // ===== Observer Pattern =====
 class IObserver {
@@ -101,60 +157,234 @@ struct Customer {
     double bill;
     Customer() {}
     Customer(string n, string i, int q, double b, int a)
-        : name(n), itemName(i), quantity(q), bill(b), age(a) {}
+        : name(move(n)), itemName(move(i)), quantity(q), age(a), bill(b) {}
 };
 
+// Pending orders remember their menu index and placement minute so a change of
+// quantity or item is re-priced under the rules in force when it was placed.
 struct TakeAwayCustomer {
     Customer customer;
-    TakeAwayCustomer* next = nullptr;
-    TakeAwayCustomer(string n, string i, int q, double b, int a)
-        : customer(n, i, q, b, a) {}
+    uint32_t id = 0;
+    int item = 0, minute = 0;
+    uint64_t sequence = 0;
+    double placedAt = 0, deadline = 0;     // seconds on the restaurant clock
+    double priority = 0;
+    size_t heapIndex = 0, deadlineIndex = 0;
+    TakeAwayCustomer(string n, const string& i, int q, double b, int a)
+        : customer(move(n), i, q, b, a) {}
+};
+
+struct TakeAwayByPriority {
+    bool operator()(const TakeAwayCustomer* a, const TakeAwayCustomer* b) const {
+        if (a->priority != b->priority) return a->priority > b->priority;
+        return a->sequence < b->sequence;
+    }
+};
+
+struct TakeAwayByDeadline {
+    bool operator()(const TakeAwayCustomer* a, const TakeAwayCustomer* b) const {
+        if (a->deadline != b->deadline) return a->deadline < b->deadline;
+        return a->sequence < b->sequence;
+    }
+};
+
+// Take-away scheduling. By default the oldest customer is served first. With
+// aging, every minute waited adds agingPerMinute to an order's priority, i.e.
+// age + rate * (now - placedAt). The rate * now term is shared by all orders, so
+// ordering by age - rate * placedAt is equivalent and fixed at placement: the
+// heap never needs re-prioritising as time passes. With an SLA every order gets
+// a deadline and misses are counted; with deadlineFirst the order with the
+// earliest deadline also jumps the queue once it is within urgentWithinMinutes
+// of missing it.
+struct TakeAwayScheduling {
+    bool aging = false;
+    double agingPerMinute = 1.0;
+    double slaMinutes = 0;             // 0 = no deadlines
+    bool deadlineFirst = false;
+    double urgentWithinMinutes = 2.0;
 };
 
+// The modes compared by --replay and offered by the scheduling command, all
+// with a 20-minute SLA: 1 age priority, 2 aging 2/min, 3 aging + SLA first.
+const int TAKEAWAY_SCHEDULING_MODES = 3;
+
+inline const char* takeAwaySchedulingName(int mode) {
+    static const char* names[] = { "Age priority", "Aging 2/min", "Aging + SLA first" };
+    return mode >= 1 && mode <= TAKEAWAY_SCHEDULING_MODES ? names[mode - 1] : "Unknown";
+}
+
+inline TakeAwayScheduling takeAwaySchedulingPreset(int mode) {
+    if (mode < 1 || mode > TAKEAWAY_SCHEDULING_MODES) throw runtime_error("Invalid scheduling mode");
+    TakeAwayScheduling s;
+    s.slaMinutes = 20;
+    s.aging = mode >= 2;
+    s.agingPerMinute = 2.0;
+    s.deadlineFirst = mode == 3;
+    return s;
+}
+
 struct DineInCustomer {
     Customer customer;
     int table;
+    uint32_t id = 0;
+    int item = 0, minute = 0;
+    DineInCustomer* prev = nullptr;
     DineInCustomer* next = nullptr;
-    DineInCustomer(string n, string i, int q, double b, int a, int t)
-        : customer(n, i, q, b, a), table(t) {}
+    DineInCustomer(string n, const string& i, int q, double b, int a, int t)
+        : customer(move(n), i, q, b, a), table(t) {}
+};
+
+struct PendingRef {
+    TakeAwayCustomer* take = nullptr;
+    DineInCustomer* dine = nullptr;
 };
 struct ServedCustomer {
-    string name, itemName, type;
-    int quantity, age;
-    double bill;
+    Customer customer;
+    OrderType type;
+    int height = 1;
     ServedCustomer* left = nullptr;
     ServedCustomer* right = nullptr;
-    ServedCustomer(string n, string i, int q, double b, int a, string t)
-        : name(n), itemName(i), quantity(q), bill(b), age(a), type(t) {}
+    ServedCustomer(Customer&& c, OrderType t)
+        : customer(move(c)), type(t) {}
 };
 
 class Restaurant {
+    uint16_t branch;
+    Logger& logger;
     vector<string> menu;
     vector<int> prices;
-    TakeAwayCustomer* nextTake = nullptr;
+    PricingEngine pricing;
+    IndexedHeap<TakeAwayCustomer, &TakeAwayCustomer::heapIndex, TakeAwayByPriority> takeQueue;
+    IndexedHeap<TakeAwayCustomer, &TakeAwayCustomer::deadlineIndex, TakeAwayByDeadline> takeDeadlines;
+    TakeAwayScheduling scheduling;
+    chrono::steady_clock::time_point clockStart = chrono::steady_clock::now();
+    double manualClock = -1;
+    int fixedMinute = -1;
+    LatencyHistogram takeAwayWaits;
+    uint64_t deadlineMisses = 0;
     DineInCustomer* nextDine = nullptr;
+    DineInCustomer* lastDine = nullptr;
+    FlatIdMap<PendingRef> pendingById;
+    uint32_t nextOrderId = 1;
+    uint64_t nextSequence = 0;
+    double pendingTotal = 0;
     ServedCustomer* servedRoot = nullptr;
+    size_t servedCount = 0;
     double totalEarned = 0;
+    ServedArchive archive;
+
+    NodePool<TakeAwayCustomer> takePool;
+    NodePool<DineInCustomer> dinePool;
+    NodePool<ServedCustomer> servedPool;
 
     // AVL Helpers
-    ServedCustomer* insertServed(ServedCustomer* root, const Customer& c, const string& type) {
-        if (!root) return new ServedCustomer(c.name, c.itemName, c.quantity, c.bill, c.age, type);
-        if (c.name < root->name)
-            root->left = insertServed(root->left, c, type);
-        else if (c.name > root->name)
-            root->right = insertServed(root->right, c, type);
-        else throw runtime_error("Duplicate customer");
+    // The customer is moved into the new node only once its slot is known, so a
+    // duplicate name throws before anything changes. The serve calls insert
+    // first, which leaves such an order pending with its bill.
+    ServedCustomer* insertServed(ServedCustomer* root, Customer& c, OrderType type, ServedCustomer*& inserted) {
+        if (!root) return inserted = servedPool.create(move(c), type);
+        if (c.name < root->customer.name)
+            root->left = insertServed(root->left, c, type, inserted);
+        else if (c.name > root->customer.name)
+            root->right = insertServed(root->right, c, type, inserted);
+        else throw runtime_error(c.name + " was already served today; cancel the order or roll over first");
         return balance(root);
     }
     void deleteTree(ServedCustomer* r) {
         if (!r) return;
         deleteTree(r->left);
         deleteTree(r->right);
-        delete r;
+        servedPool.destroy(r);
+    }
+    const Customer& archiveServed(Customer& c, OrderType type) {
+        ServedCustomer* node = nullptr;
+        servedRoot = insertServed(servedRoot, c, type, node);
+        ++servedCount;
+        totalEarned += node->customer.bill;
+        return node->customer;
+    }
+    void forEachServedNode(const function<void(const ServedCustomer&)>& cb) const {
+        vector<ServedCustomer*> stack;
+        ServedCustomer* curr = servedRoot;
+        while (curr || !stack.empty()) {
+            while (curr) { stack.push_back(curr); curr = curr->left; }
+            curr = stack.back(); stack.pop_back();
+            cb(*curr);
+            curr = curr->right;
+        }
+    }
+    static string today() {
+        time_t now = time(nullptr);
+        tm local{};
+#ifdef _WIN32
+        localtime_s(&local, &now);
+#else
+        localtime_r(&now, &local);
+#endif
+        char day[16];
+        strftime(day, sizeof(day), "%Y-%m-%d", &local);
+        return day;
+    }
+    int minuteOfDay() const { return fixedMinute >= 0 ? fixedMinute : currentMinuteOfDay(); }
+    // Take-away scheduling helpers
+    double now() const {
+        return manualClock >= 0 ? manualClock : chrono::duration<double>(chrono::steady_clock::now() - clockStart).count();
+    }
+    void schedule(TakeAwayCustomer* t) {
+        t->priority = t->customer.age - (scheduling.aging ? scheduling.agingPerMinute * t->placedAt / 60.0 : 0.0);
+        t->deadline = scheduling.slaMinutes > 0 ? t->placedAt + scheduling.slaMinutes * 60.0 : HUGE_VAL;
+    }
+    TakeAwayCustomer* nextTakeAway() const {
+        if (scheduling.deadlineFirst && scheduling.slaMinutes > 0) {
+            TakeAwayCustomer* urgent = takeDeadlines.top();
+            if (urgent->deadline - now() <= scheduling.urgentWithinMinutes * 60.0) return urgent;
+        }
+        return takeQueue.top();
+    }
+    void unqueueTakeAway(TakeAwayCustomer* t) {
+        takeQueue.remove(t);
+        takeDeadlines.remove(t);
+    }
+
+    void unlinkDineIn(DineInCustomer* node) {
+        (node->prev ? node->prev->next : nextDine) = node->next;
+        (node->next ? node->next->prev : lastDine) = node->prev;
+        node->prev = node->next = nullptr;
+    }
+
+    void forgetPending(uint32_t id, double bill) {
+        pendingById.erase(id);
+        pendingTotal = pendingById.size() ? pendingTotal - bill : 0;
+    }
+
+    PendingRef findPending(uint32_t id) {
+        PendingRef* ref = pendingById.find(id);
+        if (!ref) throw runtime_error("No pending order #" + to_string(id));
+        return *ref;
+    }
+
+    void checkMenuIndex(int index) const {
+        if (index <= 0 || index >= static_cast<int>(menu.size())) throw runtime_error("Invalid menu item");
+    }
+
+    // 0 is the id map's empty key, so the counter skips it when it wraps.
+    uint32_t takeOrderId() {
+        if (nextOrderId == 0) nextOrderId = 1;
+        return nextOrderId++;
+    }
+
+    // Re-prices a pending order after a change and updates the pending total.
+    void reprice(Customer& c, int item, int minute, OrderType type) {
+        double bill = pricing.price(item, c.quantity, c.age, type, minute);
+        pendingTotal += bill - c.bill;
+        c.bill = bill;
     }
+
     int height(ServedCustomer* r) {
-        if (!r) return 0;
-        return 1 + max(height(r->left), height(r->right));
+        return r ? r->height : 0;
+    }
+    void updateHeight(ServedCustomer* r) {
+        r->height = 1 + max(height(r->left), height(r->right));
     }
     int balanceFactor(ServedCustomer* r) {
         return height(r->left) - height(r->right);
@@ -163,15 +393,20 @@ class Restaurant {
         ServedCustomer* y = x->right;
         x->right = y->left;
         y->left = x;
+        updateHeight(x);
+        updateHeight(y);
         return y;
     }
     ServedCustomer* rotateRight(ServedCustomer* y) {
         ServedCustomer* x = y->left;
         y->left = x->right;
         x->right = y;
+        updateHeight(y);
+        updateHeight(x);
         return x;
     }
     ServedCustomer* balance(ServedCustomer* r) {
+        updateHeight(r);
         int bf = balanceFactor(r);
         if (bf > 1) {
             if (balanceFactor(r->left) < 0)
@@ -186,277 +421,1170 @@ class Restaurant {
         return r;
     }
 
-public:
-    Restaurant() {
+    Restaurant(uint16_t branchId, Logger& log, string archiveDir)
+        : branch(branchId), logger(log), archive(move(archiveDir)) {
         menu = { "", "Burger", "Pasta", "Steak", "Pizza", "Lassi" };
         prices = { 0, 250, 450, 800, 600, 150 };
+        pricing.setBasePrices(prices);
+        ifstream rules("pricing.rules");
+        try {
+            pricing.setRules(rules ? loadPricingRules(rules) : defaultPricingRules());
+            pricing.compile();
+        }
+        catch (const exception& e) {
+            cerr << "pricing.rules: " << e.what() << "; using the default rules\n";
+            pricing.setRules(defaultPricingRules());
+            pricing.compile();
+        }
+        for (const auto& path : archive.unreadableSegments())
+            cerr << "Skipping unreadable archive segment " << path << "\n";
     }
-    ~Restaurant() { deleteTree(servedRoot); }
+
+public:
+    explicit Restaurant(uint16_t branchId = 0)
+        : Restaurant(branchId, Logger::getInstance(branchId),
+            branchId ? "archive/branch" + to_string(branchId) : "archive") {}
+    // Measurement runs (replay, allocation report) log to "<name>-*" and keep
+    // any archive under archive/<name>, away from the real branches.
+    explicit Restaurant(const string& scratchName)
+        : Restaurant(0, Logger::getScratch(scratchName), "archive/" + scratchName) {}
+    ~Restaurant() {
+        deleteTree(servedRoot);
+        for (auto* node : takeQueue.nodes()) takePool.destroy(node);
+        while (nextDine) { auto* n = nextDine->next; dinePool.destroy(nextDine); nextDine = n; }
+    }
+
+    // Replays drive the restaurant clock (seconds) instead of the wall clock.
+    void setManualClock(double seconds) { manualClock = seconds; }
+
+    // Pins the minute used for time-of-day pricing; -1 reads the wall clock on
+    // every order. Shards refresh it per batch to keep localtime off the hot path.
+    void setMinuteOfDay(int minute) { fixedMinute = minute; }
+
+    // Switching modes re-keys the pending take-away orders once, in O(n).
+    void setTakeAwayScheduling(const TakeAwayScheduling& s) {
+        scheduling = s;
+        for (auto* t : takeQueue.nodes()) schedule(t);
+        takeQueue.rebuild();
+        takeDeadlines.rebuild();
+    }
+    const TakeAwayScheduling& getTakeAwayScheduling() const { return scheduling; }
+    const LatencyHistogram& getTakeAwayWaits() const { return takeAwayWaits; }
+    uint64_t getDeadlineMisses() const { return deadlineMisses; }
 
     const vector<string>& getMenu() const { return menu; }
     const vector<int>& getPrices() const { return prices; }
+    const PricingEngine& getPricing() const { return pricing; }
+
+    // Both placement calls return the order id used to cancel or modify it.
+    uint32_t placeTakeAwayOrder(string name, int index, int qty, int age) {
+        checkMenuIndex(index);
+        int minute = minuteOfDay();
+        double bill = pricing.price(index, qty, age, OrderType::TakeAway, minute);
+        auto* newNode = takePool.create(move(name), menu[index], qty, bill, age);
+        newNode->id = takeOrderId();
+        newNode->item = index;
+        newNode->minute = minute;
+        newNode->sequence = nextSequence++;
+        newNode->placedAt = now();
+        schedule(newNode);
+        takeQueue.push(newNode);
+        takeDeadlines.push(newNode);
+        pendingById.insert(newNode->id, { newNode, nullptr });
+        pendingTotal += bill;
+
+        logger.log(LogEvent::TakeAwayPlaced, newNode->customer.name, index, qty, bill, newNode->id);
+        return newNode->id;
+    }
+
 
-    void placeTakeAwayOrder(const string& name, int index, int qty, int age) {
-        double bill = prices[index] * qty;
-        auto* newNode = new TakeAwayCustomer(name, menu[index], qty, bill, age);
-        if (!nextTake || nextTake->customer.age < age) {
-            newNode->next = nextTake;
-            nextTake = newNode;
+    uint32_t placeDineInOrder(string name, int index, int qty, int age, int table) {
+        checkMenuIndex(index);
+        int minute = minuteOfDay();
+        double bill = pricing.price(index, qty, age, OrderType::DineIn, minute);
+        auto* newNode = dinePool.create(move(name), menu[index], qty, bill, age, table);
+        newNode->id = takeOrderId();
+        newNode->item = index;
+        newNode->minute = minute;
+        newNode->prev = lastDine;
+        (lastDine ? lastDine->next : nextDine) = newNode;
+        lastDine = newNode;
+        pendingById.insert(newNode->id, { nullptr, newNode });
+        pendingTotal += bill;
+
+        logger.log(LogEvent::DineInPlaced, newNode->customer.name, index, qty, bill, newNode->id);
+        return newNode->id;
+    }
+
+    // Removes a pending order: O(log n) for take-away, O(1) for dine-in.
+    Customer cancelOrder(uint32_t id) {
+        PendingRef ref = findPending(id);
+        Customer c;
+        int item = ref.take ? ref.take->item : ref.dine->item;
+        if (ref.take) {
+            unqueueTakeAway(ref.take);
+            c = move(ref.take->customer);
+            takePool.destroy(ref.take);
         }
         else {
-            auto* cur = nextTake;
-            while (cur->next && cur->next->customer.age >= age)
-                cur = cur->next;
-            newNode->next = cur->next;
-            cur->next = newNode;
+            unlinkDineIn(ref.dine);
+            c = move(ref.dine->customer);
+            dinePool.destroy(ref.dine);
         }
+        forgetPending(id, c.bill);
+        logger.log(LogEvent::OrderCancelled, c.name, item, c.quantity, c.bill, id);
+        return c;
+    }
 
-        cout << "TakeAway order placed successfully for " << name << "!\n";
-        Logger::getInstance().log("TakeAway order placed for " + name);
-        std::this_thread::sleep_for(std::chrono::milliseconds(1000));
+    // Quantity and item changes keep the order's place in its queue.
+    const Customer& changeOrderQuantity(uint32_t id, int qty) {
+        if (qty <= 0) throw runtime_error("Quantity must be positive");
+        PendingRef ref = findPending(id);
+        Customer& c = ref.take ? ref.take->customer : ref.dine->customer;
+        c.quantity = qty;
+        if (ref.take) reprice(c, ref.take->item, ref.take->minute, OrderType::TakeAway);
+        else reprice(c, ref.dine->item, ref.dine->minute, OrderType::DineIn);
+        logger.log(LogEvent::OrderModified, c.name, ref.take ? ref.take->item : ref.dine->item, c.quantity, c.bill, id);
+        return c;
     }
 
+    const Customer& changeOrderItem(uint32_t id, int index) {
+        checkMenuIndex(index);
+        PendingRef ref = findPending(id);
+        Customer& c = ref.take ? ref.take->customer : ref.dine->customer;
+        c.itemName = menu[index];
+        if (ref.take) reprice(c, ref.take->item = index, ref.take->minute, OrderType::TakeAway);
+        else reprice(c, ref.dine->item = index, ref.dine->minute, OrderType::DineIn);
+        logger.log(LogEvent::OrderModified, c.name, index, c.quantity, c.bill, id);
+        return c;
+    }
 
-    void placeDineInOrder(const string& name, int index, int qty, int age, int table) {
-        double bill = prices[index] * qty;
-        auto* newNode = new DineInCustomer(name, menu[index], qty, bill, age, table);
-        if (!nextDine) nextDine = newNode;
-        else {
-            auto* cur = nextDine;
-            while (cur->next) cur = cur->next;
-            cur->next = newNode;
-        }
 
-        cout << "DineIn order placed successfully for " << name << " at table " << table << "!\n";
-        Logger::getInstance().log("DineIn order placed for " + name);
-        std::this_thread::sleep_for(std::chrono::milliseconds(1000));
+    // The returned record lives in the served tree and stays valid until the
+    // next rollover. An order whose customer name was already served today is
+    // rejected and stays pending; no wait or SLA figures are recorded for it.
+    const Customer& serveTakeAwayOrder() {
+        int item;
+        return serveTakeAwayOrder(item);
     }
 
+    const Customer& serveDineInOrder() {
+        int item;
+        return serveDineInOrder(item);
+    }
 
-    Customer serveTakeAwayOrder() {
-        if (!nextTake) throw runtime_error("No TakeAway orders");
-        auto* temp = nextTake;
-        nextTake = nextTake->next;
-        Customer served = temp->customer;
-        servedRoot = insertServed(servedRoot, served, "TakeAway");
-        totalEarned += served.bill;
-        delete temp;
+    // Also reports the served menu index, for callers tallying items.
+    const Customer& serveTakeAwayOrder(int& item) {
+        if (takeQueue.empty()) throw runtime_error("No TakeAway orders");
+        auto* temp = nextTakeAway();
+        uint32_t id = temp->id;
+        item = temp->item;
+        double bill = temp->customer.bill;
+        const Customer& served = archiveServed(temp->customer, OrderType::TakeAway);
+        unqueueTakeAway(temp);
+        double servedAt = now();
+        takeAwayWaits.record(static_cast<uint64_t>((servedAt - temp->placedAt) * 1000.0));
+        if (servedAt > temp->deadline) ++deadlineMisses;
+        forgetPending(id, bill);
+        takePool.destroy(temp);
+        logger.log(LogEvent::TakeAwayServed, served.name, item, served.quantity, served.bill, id);
         return served;
     }
 
-    Customer serveDineInOrder() {
+    const Customer& serveDineInOrder(int& item) {
         if (!nextDine) throw runtime_error("No DineIn orders");
         auto* temp = nextDine;
-        nextDine = nextDine->next;
-        Customer served = temp->customer;
-        servedRoot = insertServed(servedRoot, served, "DineIn");
-        totalEarned += served.bill;
-        delete temp;
+        uint32_t id = temp->id;
+        item = temp->item;
+        double bill = temp->customer.bill;
+        const Customer& served = archiveServed(temp->customer, OrderType::DineIn);
+        unlinkDineIn(temp);
+        forgetPending(id, bill);
+        dinePool.destroy(temp);
+        logger.log(LogEvent::DineInServed, served.name, item, served.quantity, served.bill, id);
         return served;
     }
 
-    void serveAllOrders(const function<void(const Customer&)>& cb) {
-        while (nextTake) cb(serveTakeAwayOrder());
-        while (nextDine) cb(serveDineInOrder());
+    void serveAllOrders(const function<void(const Customer&, int item)>& cb) {
+        int item;
+        while (!takeQueue.empty()) {
+            const Customer& c = serveTakeAwayOrder(item);
+            cb(c, item);
+        }
+        while (nextDine) {
+            const Customer& c = serveDineInOrder(item);
+            cb(c, item);
+        }
+    }
+
+    // In-order walk over today's served orders without copying any record.
+    void forEachServed(const function<void(const Customer&)>& cb) const {
+        forEachServedNode([&](const ServedCustomer& n) { cb(n.customer); });
+    }
+
+    // Freezes today's served orders into a read-only archive segment and resets
+    // the live tree and the day's earnings. Pending orders carry over.
+    // Returns the number of orders archived (0 when nothing was served).
+    size_t endOfDayRollover() {
+        if (!servedRoot) return 0;
+        string day = today();
+        ServedSegment segment(day, totalEarned);
+        segment.reserve(servedCount);
+        forEachServedNode([&](const ServedCustomer& n) {
+            const Customer& c = n.customer;
+            segment.append(c.name, c.itemName, static_cast<uint8_t>(n.type), c.quantity, c.age, c.bill);
+        });
+        size_t frozen = servedCount;
+        double dayTotal = totalEarned;
+        archive.add(move(segment));
+
+        deleteTree(servedRoot);
+        servedPool.release();
+        servedRoot = nullptr;
+        servedCount = 0;
+        totalEarned = 0;
+
+        logger.log(LogEvent::Rollover, day, 0, static_cast<int>(frozen), dayTotal);
+        return frozen;
     }
 
     vector<Customer> getServedOrders() const {
         vector<Customer> list;
-        vector<ServedCustomer*> stack;
-        ServedCustomer* curr = servedRoot;
-        while (curr || !stack.empty()) {
-            while (curr) { stack.push_back(curr); curr = curr->left; }
-            curr = stack.back(); stack.pop_back();
-            list.push_back({ curr->name, curr->itemName, curr->quantity, curr->bill, curr->age });
-            curr = curr->right;
-        }
+        list.reserve(servedCount);
+        forEachServed([&](const Customer& c) { list.push_back(c); });
         return list;
     }
 
-    double calculatePendingBill() const {
-        double total = 0;
-        for (auto* c = nextTake; c; c = c->next) total += c->customer.bill;
-        for (auto* c = nextDine; c; c = c->next) total += c->customer.bill;
-        return total;
-    }
+    double calculatePendingBill() const { return pendingTotal; }
+    size_t pendingCount() const { return pendingById.size(); }
 
-    double getTotalEarnings() const { return totalEarned; }
-    TakeAwayCustomer* getNextTakeAway() const { return nextTake; }
-    DineInCustomer* getNextDineIn() const { return nextDine; }
+    void flushLog() { logger.flush(); }
 
-    bool searchServedOrderByName(const string& name) const {
+    double getTotalEarnings() const { return archive.getEarnings() + totalEarned; }
+    size_t getArchivedDays() const { return archive.segmentCount(); }
+    double getTodayEarnings() const { return totalEarned; }
+    uint16_t getBranch() const { return branch; }
+
+    // Pending take-away orders by priority (sorts a copy of the heap); orders
+    // close to their SLA deadline may still be served ahead of this order.
+    void forEachPendingTakeAway(const function<void(uint32_t, const Customer&)>& cb) const {
+        vector<TakeAwayCustomer*> order(takeQueue.nodes());
+        sort(order.begin(), order.end(), TakeAwayByPriority());
+        for (auto* t : order) cb(t->id, t->customer);
+    }
+    void forEachPendingDineIn(const function<void(uint32_t, const Customer&, int)>& cb) const {
+        for (auto* d = nextDine; d; d = d->next) cb(d->id, d->customer, d->table);
+    }
+
+    // Searches today's tree first, then every archived day, newest first.
+    bool searchServedOrderByName(const string& name, ostream& out = cout) const {
+        logger.log(LogEvent::Search, name);
+        bool found = false;
         ServedCustomer* curr = servedRoot;
         while (curr) {
-            if (curr->name == name) {
-                cout << " Found: " << curr->name << " ordered " << curr->itemName
-                    << " (" << curr->quantity << ") - Rs. " << curr->bill
-                    << " [" << curr->type << "]\n";
-                return true;
+            const Customer& c = curr->customer;
+            if (c.name == name) {
+                out << " Found: " << c.name << " ordered " << c.itemName
+                    << " (" << c.quantity << ") - Rs. " << c.bill
+                    << " [" << orderTypeName(curr->type) << "]\n";
+                found = true;
+                break;
             }
-            if (name < curr->name)
+            if (name < c.name)
                 curr = curr->left;
             else
                 curr = curr->right;
         }
-        cout << " No served order found for: " << name << endl;
-        return false;
+        archive.findAll(name, [&](const ServedSegment& seg, size_t i) {
+            out << " Found: " << seg.nameAt(i) << " ordered " << seg.itemAt(i)
+                << " (" << seg.quantityAt(i) << ") - Rs. " << seg.billAt(i)
+                << " [" << orderTypeName(static_cast<OrderType>(seg.typeAt(i))) << ", " << seg.getDay() << "]\n";
+            found = true;
+        }, [](const string& path) {
+            cerr << "Skipping corrupt archive segment " << path << "\n";
+        });
+        if (!found) out << " No served order found for: " << name << endl;
+        return found;
     }
 };
 
-// ===== Console UI =====
-void showMenu(const vector<string>& menu, const vector<int>& prices) {
-    cout << "\n===== MENU =====\n";
-    for (size_t i = 1; i < menu.size(); ++i)
-        cout << i << ". " << menu[i] << " - Rs. " << prices[i] << endl;
-}
+// ===== Multi-Branch Cluster =====
+// Every branch is a Restaurant shard owned by one pinned worker thread, fed
+// through its own lock-free command queue. Workers publish their figures into a
+// per-branch sequence-locked block, so reports read all branches without
+// stopping any of them.
+struct BranchCommand {
+    enum Kind : uint8_t { PlaceTakeAway, PlaceDineIn, ServeAll, Rollover };
+    Kind kind = ServeAll;
+    string name;
+    int item = 0, qty = 0, age = 0, table = 0;
+};
 
+struct BranchSnapshot {
+    static const int MAX_ITEMS = 16;
+    double earnings = 0, pending = 0;
+    uint64_t processed = 0, served = 0, failed = 0;
+    uint64_t itemQty[MAX_ITEMS] = {};
+};
 
-int main() 
-{
-    Logger::getInstance().log("System Started");
-    Restaurant restaurant;
-    EventManager manager;
-    manager.addObserver(new AnalyticsObserver());
-    manager.addObserver(new NotificationObserver());
+class alignas(64) BranchStats {
+    atomic<uint64_t> version{ 0 };
+    atomic<double> earnings{ 0 }, pending{ 0 };
+    atomic<uint64_t> processed{ 0 }, served{ 0 }, failed{ 0 };
+    atomic<uint64_t> itemQty[BranchSnapshot::MAX_ITEMS] = {};
 
-    User user;
-    cout << CYAN << "User Type (1 = Admin, 2 = Guest): " << RESET;
-    std::this_thread::sleep_for(std::chrono::milliseconds(1000));
-    int type; cin >> type;
-    if (type == 1) user.setStrategy(new AdminStrategy());
-    else user.setStrategy(new GuestStrategy());
-    user.accessDashboard();
-
-    bool run = true;
-    while (run) {
-        cout << CYAN << "\n==== Welcome! What would you like to do? ====\n" << RESET;
-        std::this_thread::sleep_for(std::chrono::milliseconds(1000));
-
-        cout << YELLOW << "1. Show Menu\n" << RESET;
-        cout << YELLOW << "2. Place TakeAway Order\n" << RESET;
-        cout << YELLOW << "3. Place DineIn Order\n" << RESET;
-        cout << YELLOW << "4. Serve TakeAway Order\n" << RESET;
-        cout << YELLOW << "5. Serve DineIn Order\n" << RESET;
-        cout << YELLOW << "6. Serve All Orders\n" << RESET;
-        cout << YELLOW << "7. View Served Orders\n" << RESET;
-        cout << YELLOW << "8. View Pending Orders\n" << RESET;
-        cout << YELLOW << "9. View Pending Bill\n" << RESET;
-        cout << YELLOW << "10. View Total Earnings\n" << RESET;
-        cout << YELLOW << "11. Search Served Orders by Name\n" << RESET;
-        cout << RED << "12. Exit\n" << RESET;
-        cout << CYAN << "Choice: " << RESET;
-        std::this_thread::sleep_for(std::chrono::milliseconds(1000));
-
-        int ch; cin >> ch;
-
-        if (ch == 1) showMenu(restaurant.getMenu(), restaurant.getPrices());
-
-        else if (ch == 2) {
-            string n; int i, q, a;
-            cout << CYAN << "Name: " << RESET; std::this_thread::sleep_for(std::chrono::milliseconds(1000)); cin >> n;
-            cout << CYAN << "Menu Index: " << RESET; std::this_thread::sleep_for(std::chrono::milliseconds(1000)); cin >> i;
-            cout << CYAN << "Qty: " << RESET; std::this_thread::sleep_for(std::chrono::milliseconds(1000)); cin >> q;
-            cout << CYAN << "Age: " << RESET; std::this_thread::sleep_for(std::chrono::milliseconds(1000)); cin >> a;
-            restaurant.placeTakeAwayOrder(n, i, q, a);
-        }
+public:
+    // Single writer: the branch's worker thread.
+    void publish(const BranchSnapshot& s) {
+        uint64_t v = version.load(memory_order_relaxed);
+        version.store(v + 1, memory_order_relaxed);
+        atomic_thread_fence(memory_order_release);
+        earnings.store(s.earnings, memory_order_relaxed);
+        pending.store(s.pending, memory_order_relaxed);
+        processed.store(s.processed, memory_order_relaxed);
+        served.store(s.served, memory_order_relaxed);
+        failed.store(s.failed, memory_order_relaxed);
+        for (int i = 0; i < BranchSnapshot::MAX_ITEMS; ++i)
+            itemQty[i].store(s.itemQty[i], memory_order_relaxed);
+        version.store(v + 2, memory_order_release);
+    }
 
-        else if (ch == 3) {
-            string n; int i, q, a, t;
-            cout << CYAN << "Name: " << RESET; std::this_thread::sleep_for(std::chrono::milliseconds(1000)); cin >> n;
-            cout << CYAN << "Menu Index: " << RESET; std::this_thread::sleep_for(std::chrono::milliseconds(1000)); cin >> i;
-            cout << CYAN << "Qty: " << RESET; std::this_thread::sleep_for(std::chrono::milliseconds(1000)); cin >> q;
-            cout << CYAN << "Age: " << RESET; std::this_thread::sleep_for(std::chrono::milliseconds(1000)); cin >> a;
-            cout << CYAN << "Table: " << RESET; std::this_thread::sleep_for(std::chrono::milliseconds(1000)); cin >> t;
-            restaurant.placeDineInOrder(n, i, q, a, t);
+    BranchSnapshot read() const {
+        BranchSnapshot s;
+        for (;;) {
+            uint64_t v = version.load(memory_order_acquire);
+            if (v & 1) { this_thread::yield(); continue; }
+            s.earnings = earnings.load(memory_order_relaxed);
+            s.pending = pending.load(memory_order_relaxed);
+            s.processed = processed.load(memory_order_relaxed);
+            s.served = served.load(memory_order_relaxed);
+            s.failed = failed.load(memory_order_relaxed);
+            for (int i = 0; i < BranchSnapshot::MAX_ITEMS; ++i)
+                s.itemQty[i] = itemQty[i].load(memory_order_relaxed);
+            atomic_thread_fence(memory_order_acquire);
+            if (version.load(memory_order_relaxed) == v) return s;
         }
+    }
+};
 
-        else if (ch == 4) {
-            try {
-                Customer c = restaurant.serveTakeAwayOrder();
-                manager.notifyAll("TakeAway order served: " + c.name);
-            }
-            catch (const exception& e) {
-                cout << RED << e.what() << RESET << endl;
-                std::this_thread::sleep_for(std::chrono::milliseconds(1000));
+class BranchShard {
+    Restaurant restaurant;
+    BoundedQueue<BranchCommand> queue;
+    BranchStats stats;
+    BranchSnapshot local;
+    unsigned core;
+    atomic<bool> stopping{ false };
+    thread worker;
+
+    void apply(BranchCommand& cmd) {
+        try {
+            switch (cmd.kind) {
+            case BranchCommand::PlaceTakeAway:
+                restaurant.placeTakeAwayOrder(move(cmd.name), cmd.item, cmd.qty, cmd.age);
+                break;
+            case BranchCommand::PlaceDineIn:
+                restaurant.placeDineInOrder(move(cmd.name), cmd.item, cmd.qty, cmd.age, cmd.table);
+                break;
+            case BranchCommand::ServeAll:
+                restaurant.serveAllOrders([&](const Customer& c, int item) {
+                    ++local.served;
+                    if (item < BranchSnapshot::MAX_ITEMS) local.itemQty[item] += c.quantity;
+                    });
+                break;
+            case BranchCommand::Rollover:
+                restaurant.endOfDayRollover();
+                break;
             }
         }
+        catch (const exception&) {
+            ++local.failed;
+        }
+        ++local.processed;
+    }
 
-        else if (ch == 5) {
-            try {
-                Customer c = restaurant.serveDineInOrder();
-                manager.notifyAll("DineIn order served: " + c.name);
+    void publish() {
+        local.earnings = restaurant.getTotalEarnings();
+        local.pending = restaurant.calculatePendingBill();
+        stats.publish(local);
+    }
+
+    void run() {
+        pinThisThreadToCore(core);
+        BranchCommand cmd;
+        bool unflushed = false;
+        for (;;) {
+            int drained = 0;
+            while (queue.tryPop(cmd)) {
+                if (drained % 256 == 0) restaurant.setMinuteOfDay(currentMinuteOfDay());
+                apply(cmd);
+                if (++drained % 256 == 0) publish();
+            }
+            if (drained) {
+                publish();
+                unflushed = true;
+                continue;
             }
-            catch (const exception& e) {
-                cout << RED << e.what() << RESET << endl;
-                std::this_thread::sleep_for(std::chrono::milliseconds(1000));
+            if (unflushed) {
+                restaurant.flushLog();
+                unflushed = false;
             }
+            if (stopping.load(memory_order_acquire)) break;
+            this_thread::sleep_for(chrono::microseconds(50));
         }
+    }
+
+public:
+    BranchShard(uint16_t branch, unsigned pinnedCore, size_t queueCapacity)
+        : restaurant(branch), queue(queueCapacity), core(pinnedCore) {
+        worker = thread([this] { run(); });
+    }
+
+    bool trySubmit(BranchCommand&& cmd) { return queue.tryPush(move(cmd)); }
+    BranchSnapshot snapshot() const { return stats.read(); }
+    const vector<string>& getMenu() const { return restaurant.getMenu(); }
+    const PricingEngine& getPricing() const { return restaurant.getPricing(); }
+
+    void stop() {
+        stopping.store(true, memory_order_release);
+        if (worker.joinable()) worker.join();
+    }
+    ~BranchShard() { stop(); }
+};
+
+struct ClusterReport {
+    double earnings = 0, pending = 0;
+    uint64_t processed = 0, served = 0, failed = 0;
+    vector<pair<string, uint64_t>> topItems;
+    vector<BranchSnapshot> branches;
+};
 
-        else if (ch == 6) {
-            restaurant.serveAllOrders([&](const Customer& c) {
-                manager.notifyAll("Order served: " + c.name);
-                });
+class BranchCluster {
+    vector<unique_ptr<BranchShard>> shards;
+
+public:
+    // Branches are numbered from 1; branch 0 is the interactive console restaurant.
+    explicit BranchCluster(int branches, size_t queueCapacity = 1 << 14) {
+        if (branches < 1 || branches > UINT16_MAX) throw invalid_argument("Branch count must be between 1 and 65535");
+        for (int i = 0; i < branches; ++i)
+            shards.push_back(make_unique<BranchShard>(static_cast<uint16_t>(i + 1), static_cast<unsigned>(i), queueCapacity));
+    }
+
+    size_t size() const { return shards.size(); }
+    // Every branch loads the same pricing.rules, and the engine is read-only.
+    const PricingEngine& getPricing() const { return shards.front()->getPricing(); }
+
+    // Blocks (spinning) only while that branch's queue is full.
+    void submit(size_t branch, BranchCommand cmd) {
+        BranchShard& shard = *shards.at(branch - 1);
+        while (!shard.trySubmit(move(cmd))) this_thread::yield();
+    }
+
+    ClusterReport aggregate(size_t topN = 3) const {
+        ClusterReport r;
+        uint64_t qty[BranchSnapshot::MAX_ITEMS] = {};
+        for (const auto& shard : shards) {
+            BranchSnapshot s = shard->snapshot();
+            r.earnings += s.earnings;
+            r.pending += s.pending;
+            r.processed += s.processed;
+            r.served += s.served;
+            r.failed += s.failed;
+            for (int i = 0; i < BranchSnapshot::MAX_ITEMS; ++i) qty[i] += s.itemQty[i];
+            r.branches.push_back(s);
         }
+        if (shards.empty()) return r;
+        const auto& menu = shards.front()->getMenu();
+        for (size_t i = 1; i < menu.size() && i < static_cast<size_t>(BranchSnapshot::MAX_ITEMS); ++i)
+            if (qty[i]) r.topItems.push_back({ menu[i], qty[i] });
+        sort(r.topItems.begin(), r.topItems.end(), [](const auto& a, const auto& b) { return a.second > b.second; });
+        if (r.topItems.size() > topN) r.topItems.resize(topN);
+        return r;
+    }
 
-        else if (ch == 7) {
-            for (auto& c : restaurant.getServedOrders()) {
-                cout << GREEN << c.name << " ordered " << c.itemName << " (" << c.quantity << ") - Rs. " << c.bill << RESET << endl;
-                std::this_thread::sleep_for(std::chrono::milliseconds(1000));
+    void stop() {
+        for (auto& shard : shards) shard->stop();
+    }
+};
+
+void printClusterReport(const ClusterReport& r) {
+    cout << fixed << setprecision(2);
+    cout << "Branches: " << r.branches.size() << "  Commands: " << r.processed << "  Served: " << r.served
+        << "  Failed: " << r.failed << "\nEarnings: Rs. " << r.earnings << "  Pending: Rs. " << r.pending << "\nTop items:";
+    for (const auto& item : r.topItems) cout << " " << item.first << " (" << item.second << ")";
+    cout << endl;
+    for (size_t i = 0; i < r.branches.size(); ++i)
+        cout << "  Branch " << i + 1 << ": Rs. " << r.branches[i].earnings << " earned, Rs. "
+        << r.branches[i].pending << " pending, " << r.branches[i].served << " served\n";
+}
+
+// Drives every branch from its own producer thread and reports throughput.
+// The earnings are then checked against the same orders priced in one batch.
+void runBranchBenchmark(int branches, int ordersPerBranch) {
+    BranchCluster cluster(branches);
+    auto orderAt = [](int i, BranchCommand& cmd) {
+        cmd.kind = i % 2 ? BranchCommand::PlaceDineIn : BranchCommand::PlaceTakeAway;
+        cmd.item = 1 + i % 5;
+        cmd.qty = 1 + i % 3;
+        cmd.age = 18 + i % 60;
+        cmd.table = 1 + i % 12;
+    };
+    int startMinute = currentMinuteOfDay();
+    auto start = chrono::steady_clock::now();
+
+    vector<thread> producers;
+    for (int b = 1; b <= branches; ++b) {
+        producers.emplace_back([&cluster, &orderAt, b, ordersPerBranch] {
+            for (int i = 0; i < ordersPerBranch; ++i) {
+                BranchCommand cmd;
+                orderAt(i, cmd);
+                cmd.name = "C" + to_string(i);
+                cluster.submit(b, move(cmd));
+                if (i % 32 == 31) cluster.submit(b, BranchCommand());
             }
-        }
+            cluster.submit(b, BranchCommand());
+        });
+    }
+
+    uint64_t expected = static_cast<uint64_t>(branches) * (ordersPerBranch + ordersPerBranch / 32 + 1);
+    ClusterReport report = cluster.aggregate();
+    while (report.processed < expected) {
+        this_thread::sleep_for(chrono::milliseconds(100));
+        report = cluster.aggregate();
+    }
+    double secs = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    for (auto& p : producers) p.join();
+    cluster.stop();
+
+    OrderBatch batch;
+    for (int i = 0; i < ordersPerBranch; ++i) {
+        BranchCommand cmd;
+        orderAt(i, cmd);
+        batch.add(cmd.item, cmd.qty, cmd.age,
+            cmd.kind == BranchCommand::PlaceDineIn ? OrderType::DineIn : OrderType::TakeAway, startMinute);
+    }
+    vector<double> bills;
+    cluster.getPricing().priceBatch(batch, bills);
+    double batchEarnings = 0;
+    for (double bill : bills) batchEarnings += bill;
+    batchEarnings *= branches;
+
+    printClusterReport(report);
+    cout << "Orders/sec: " << static_cast<uint64_t>(branches * ordersPerBranch / secs)
+        << " (" << hardwareCores() << " cores)" << endl;
+    cout << "Batch-priced earnings: Rs. " << batchEarnings
+        << (fabs(batchEarnings - report.earnings) < 0.01 * branches * ordersPerBranch ? " (matches)" : " (MISMATCH)") << endl;
+    cout.unsetf(ios::floatfield);
+}
+
+// ===== Take-Away Replay =====
+// Replays a take-away trace under each scheduling mode and reports wait-time
+// percentiles and SLA misses. Trace lines: "<seconds> place <name> <item> <qty> <age>"
+// or "<seconds> serve"; without a file a synthetic rush is generated in which
+// seniors arrive fast enough to starve younger customers under plain age priority.
+struct ReplayEvent {
+    double at = 0;
+    bool place = false;
+    string name;
+    int item = 1, qty = 1, age = 0;
+};
+
+vector<ReplayEvent> loadReplayTrace(const string& path) {
+    vector<ReplayEvent> trace;
+    ifstream in(path);
+    if (!in) throw runtime_error("Cannot open trace " + path);
+    string line, op;
+    for (size_t lineNo = 1; getline(in, line); ++lineNo) {
+        istringstream fields(line);
+        ReplayEvent e;
+        if (!(fields >> e.at >> op) || line[0] == '#') continue;
+        e.place = op == "place";
+        if ((!e.place && op != "serve") || (e.place && !(fields >> e.name >> e.item >> e.qty >> e.age)))
+            throw runtime_error("Bad trace line " + to_string(lineNo) + ": " + line);
+        trace.push_back(e);
+    }
+    stable_sort(trace.begin(), trace.end(), [](const ReplayEvent& a, const ReplayEvent& b) { return a.at < b.at; });
+    return trace;
+}
+
+vector<ReplayEvent> syntheticReplayTrace(double hours) {
+    vector<ReplayEvent> trace;
+    mt19937 rng(42);
+    exponential_distribution<double> seniorGap(1.0 / 60), youngGap(0.25 / 60);
+    uniform_int_distribution<int> seniorAge(60, 85), youngAge(18, 30), item(1, 5), qty(1, 3);
+    double end = hours * 3600;
+    int n = 0;
+    for (double t = seniorGap(rng); t < end; t += seniorGap(rng))
+        trace.push_back({ t, true, "S" + to_string(n++), item(rng), qty(rng), seniorAge(rng) });
+    for (double t = youngGap(rng); t < end; t += youngGap(rng))
+        trace.push_back({ t, true, "Y" + to_string(n++), item(rng), qty(rng), youngAge(rng) });
+    for (double t = 48; t < end + 3600; t += 48) {
+        ReplayEvent serve;
+        serve.at = t;
+        trace.push_back(serve);
+    }
+    stable_sort(trace.begin(), trace.end(), [](const ReplayEvent& a, const ReplayEvent& b) { return a.at < b.at; });
+    return trace;
+}
 
-        else if (ch == 8) {
-            cout << CYAN << "\nPending Orders:\n" << RESET;
-            std::this_thread::sleep_for(std::chrono::milliseconds(1000));
+void runReplay(const string& path) {
+    vector<ReplayEvent> trace = path.empty() ? syntheticReplayTrace(8) : loadReplayTrace(path);
 
-            TakeAwayCustomer* t = restaurant.getNextTakeAway();
-            while (t) {
-                cout << "[TakeAway] " << t->customer.name << " - " << t->customer.itemName
-                    << " (" << t->customer.quantity << ") - Rs. " << t->customer.bill << endl;
-                std::this_thread::sleep_for(std::chrono::milliseconds(1000));
-                t = t->next;
+    cout << "Replaying " << trace.size() << " events, SLA 20 min\n";
+    cout << left << setw(20) << "Mode" << right << setw(8) << "Served" << setw(10) << "p50 (s)"
+        << setw(10) << "p99 (s)" << setw(10) << "max (s)" << setw(10) << "Missed" << setw(10) << "Left" << endl;
+    for (int mode = 1; mode <= TAKEAWAY_SCHEDULING_MODES; ++mode) {
+        Restaurant restaurant("replay");
+        restaurant.setTakeAwayScheduling(takeAwaySchedulingPreset(mode));
+        for (const auto& e : trace) {
+            restaurant.setManualClock(e.at);
+            try {
+                if (e.place) restaurant.placeTakeAwayOrder(e.name, e.item, e.qty, e.age);
+                else restaurant.serveTakeAwayOrder();
             }
+            catch (const exception&) {}
+        }
+        const LatencyHistogram& waits = restaurant.getTakeAwayWaits();
+        cout << left << setw(20) << takeAwaySchedulingName(mode) << right << setw(8) << waits.count()
+            << setw(10) << waits.percentile(0.50) / 1000 << setw(10) << waits.percentile(0.99) / 1000
+            << setw(10) << waits.max() / 1000 << setw(10) << restaurant.getDeadlineMisses()
+            << setw(10) << restaurant.pendingCount() << endl;
+    }
+}
+
+// ===== Console UI =====
+void showMenu(const vector<string>& menu, const vector<int>& prices, ostream& out = cout) {
+    out << "\n===== MENU =====\n";
+    for (size_t i = 1; i < menu.size(); ++i)
+        out << i << ". " << menu[i] << " - Rs. " << prices[i] << endl;
+}
+
+// ===== Commands =====
+// One constexpr table describes every command. It drives the interactive
+// menu, the batch driver and executeCommandLine() (the hook for a network
+// front end). Each role gets its own dispatch array built from the table at
+// compile time, so a command number maps straight to a function pointer and
+// a Guest's mutating entries already point at rejectCommand.
+struct CommandContext {
+    Restaurant& restaurant;
+    EventManager& events;
+    istream& in;
+    ostream& out;
+    bool interactive;
+    bool running = true;
 
-            DineInCustomer* d = restaurant.getNextDineIn();
-            while (d) {
-                cout << "[DineIn] " << d->customer.name << " - " << d->customer.itemName
-                    << " (" << d->customer.quantity << ") - Rs. " << d->customer.bill
-                    << " [Table " << d->table << "]" << endl;
-                std::this_thread::sleep_for(std::chrono::milliseconds(1000));
-                d = d->next;
+    // Colors and the pacing delay are for the console only.
+    const char* color(const char* c) const { return interactive ? c : ""; }
+    void pause() const {
+        if (interactive) std::this_thread::sleep_for(std::chrono::milliseconds(1000));
+    }
+
+    template <typename T>
+    T read(const char* prompt) {
+        if (interactive) { out << CYAN << prompt << RESET; pause(); }
+        T value{};
+        if (!(in >> value)) {
+            // Drop the bad line so the console session can take the next command.
+            if (interactive && !in.eof()) {
+                in.clear();
+                in.ignore(numeric_limits<streamsize>::max(), '\n');
             }
+            string field(prompt);
+            field.erase(field.find_last_not_of(": ") + 1);
+            throw runtime_error("Missing or invalid input for " + field);
         }
+        return value;
+    }
+
+    void fail(const exception& e) {
+        out << color(RED) << e.what() << color(RESET) << endl;
+        pause();
+    }
+};
+
+using CommandHandler = void (*)(CommandContext&);
+
+void showMenuCommand(CommandContext& ctx) {
+    showMenu(ctx.restaurant.getMenu(), ctx.restaurant.getPrices(), ctx.out);
+}
 
-        else if (ch == 9) {
-            cout << YELLOW << "Pending: Rs. " << restaurant.calculatePendingBill() << RESET << endl;
-            std::this_thread::sleep_for(std::chrono::milliseconds(1000));
+void placeTakeAwayCommand(CommandContext& ctx) {
+    auto n = ctx.read<string>("Name: ");
+    int i = ctx.read<int>("Menu Index: ");
+    int q = ctx.read<int>("Qty: ");
+    int a = ctx.read<int>("Age: ");
+    uint32_t id = ctx.restaurant.placeTakeAwayOrder(n, i, q, a);
+    ctx.out << "TakeAway order #" << id << " placed successfully for " << n << "!\n";
+    ctx.pause();
+}
+
+void placeDineInCommand(CommandContext& ctx) {
+    auto n = ctx.read<string>("Name: ");
+    int i = ctx.read<int>("Menu Index: ");
+    int q = ctx.read<int>("Qty: ");
+    int a = ctx.read<int>("Age: ");
+    int t = ctx.read<int>("Table: ");
+    uint32_t id = ctx.restaurant.placeDineInOrder(n, i, q, a, t);
+    ctx.out << "DineIn order #" << id << " placed successfully for " << n << " at table " << t << "!\n";
+    ctx.pause();
+}
+
+void serveTakeAwayCommand(CommandContext& ctx) {
+    const Customer& c = ctx.restaurant.serveTakeAwayOrder();
+    ctx.events.notifyAll("TakeAway order served: " + c.name);
+}
+
+void serveDineInCommand(CommandContext& ctx) {
+    const Customer& c = ctx.restaurant.serveDineInOrder();
+    ctx.events.notifyAll("DineIn order served: " + c.name);
+}
+
+void serveAllCommand(CommandContext& ctx) {
+    ctx.restaurant.serveAllOrders([&](const Customer& c, int) {
+        ctx.events.notifyAll("Order served: " + c.name);
+        });
+}
+
+void viewServedCommand(CommandContext& ctx) {
+    ctx.restaurant.forEachServed([&](const Customer& c) {
+        ctx.out << ctx.color(GREEN) << c.name << " ordered " << c.itemName << " (" << c.quantity << ") - Rs. " << c.bill << ctx.color(RESET) << endl;
+        ctx.pause();
+        });
+}
+
+void viewPendingCommand(CommandContext& ctx) {
+    ctx.out << ctx.color(CYAN) << "\nPending Orders:\n" << ctx.color(RESET);
+    ctx.pause();
+
+    ctx.restaurant.forEachPendingTakeAway([&](uint32_t id, const Customer& c) {
+        ctx.out << "[TakeAway #" << id << "] " << c.name << " - " << c.itemName
+            << " (" << c.quantity << ") - Rs. " << c.bill << endl;
+        ctx.pause();
+        });
+
+    ctx.restaurant.forEachPendingDineIn([&](uint32_t id, const Customer& c, int table) {
+        ctx.out << "[DineIn #" << id << "] " << c.name << " - " << c.itemName
+            << " (" << c.quantity << ") - Rs. " << c.bill
+            << " [Table " << table << "]" << endl;
+        ctx.pause();
+        });
+}
+
+void pendingBillCommand(CommandContext& ctx) {
+    ctx.out << ctx.color(YELLOW) << "Pending: Rs. " << ctx.restaurant.calculatePendingBill() << ctx.color(RESET) << endl;
+    ctx.pause();
+}
+
+void earningsCommand(CommandContext& ctx) {
+    ctx.out << ctx.color(YELLOW) << "Earnings: Rs. " << ctx.restaurant.getTotalEarnings()
+        << " (today: Rs. " << ctx.restaurant.getTodayEarnings() << ")" << ctx.color(RESET) << endl;
+    ctx.pause();
+}
+
+void searchCommand(CommandContext& ctx) {
+    auto name = ctx.read<string>("Enter customer name to search: ");
+    ctx.restaurant.searchServedOrderByName(name, ctx.out);
+    ctx.pause();
+}
+
+void cancelCommand(CommandContext& ctx) {
+    auto id = ctx.read<uint32_t>("Order #: ");
+    Customer c = ctx.restaurant.cancelOrder(id);
+    ctx.events.notifyAll("Order cancelled: " + c.name);
+}
+
+void modifyCommand(CommandContext& ctx) {
+    auto id = ctx.read<uint32_t>("Order #: ");
+    int what = ctx.read<int>("Change (1 = Qty, 2 = Menu Index): ");
+    if (what != 1 && what != 2) throw runtime_error("Invalid choice");
+    int value = ctx.read<int>("New value: ");
+    const Customer& c = what == 2 ? ctx.restaurant.changeOrderItem(id, value) : ctx.restaurant.changeOrderQuantity(id, value);
+    ctx.out << ctx.color(GREEN) << "Order #" << id << " now " << c.itemName << " (" << c.quantity << ") - Rs. " << c.bill << ctx.color(RESET) << endl;
+    ctx.events.notifyAll("Order modified: " + c.name);
+    ctx.pause();
+}
+
+void rolloverCommand(CommandContext& ctx) {
+    double dayTotal = ctx.restaurant.getTodayEarnings();
+    size_t archived = ctx.restaurant.endOfDayRollover();
+    if (!archived) ctx.out << "Nothing served today, nothing to archive.\n";
+    else ctx.out << "Archived " << archived << " served orders (Rs. " << dayTotal << "). "
+        << ctx.restaurant.getArchivedDays() << " day(s) on record.\n";
+    ctx.pause();
+}
+
+void schedulingCommand(CommandContext& ctx) {
+    const LatencyHistogram& waits = ctx.restaurant.getTakeAwayWaits();
+    ctx.out << "TakeAway waits: p50 " << waits.percentile(0.50) / 1000 << " s, p99 " << waits.percentile(0.99) / 1000
+        << " s, SLA misses " << ctx.restaurant.getDeadlineMisses() << "\n";
+    int mode = ctx.read<int>("Scheduling (1 = Age priority, 2 = Aging 2/min, 3 = Aging + SLA first): ");
+    ctx.restaurant.setTakeAwayScheduling(takeAwaySchedulingPreset(mode));
+    ctx.out << "TakeAway scheduling: " << takeAwaySchedulingName(mode) << " (SLA 20 min)\n";
+    ctx.pause();
+}
+
+void exitCommand(CommandContext& ctx) { ctx.running = false; }
+
+void invalidCommand(CommandContext& ctx) {
+    ctx.out << ctx.color(RED) << "Invalid option" << ctx.color(RESET) << endl;
+    ctx.pause();
+}
+
+void rejectCommand(CommandContext& ctx) {
+    ctx.out << ctx.color(RED) << "Not permitted for this user type" << ctx.color(RESET) << endl;
+    ctx.pause();
+}
+
+struct CommandDescriptor {
+    int number;
+    const char* keyword;
+    const char* label;
+    bool mutating;
+    CommandHandler handler;
+};
+
+constexpr CommandDescriptor commandTable[] = {
+    { 1, "menu", "Show Menu", false, showMenuCommand },
+    { 2, "takeaway", "Place TakeAway Order", true, placeTakeAwayCommand },
+    { 3, "dinein", "Place DineIn Order", true, placeDineInCommand },
+    { 4, "serve-takeaway", "Serve TakeAway Order", true, serveTakeAwayCommand },
+    { 5, "serve-dinein", "Serve DineIn Order", true, serveDineInCommand },
+    { 6, "serve-all", "Serve All Orders", true, serveAllCommand },
+    { 7, "served", "View Served Orders", false, viewServedCommand },
+    { 8, "pending", "View Pending Orders", false, viewPendingCommand },
+    { 9, "bill", "View Pending Bill", false, pendingBillCommand },
+    { 10, "earnings", "View Total Earnings", false, earningsCommand },
+    { 11, "search", "Search Served Orders by Name", false, searchCommand },
+    { 12, "cancel", "Cancel Order", true, cancelCommand },
+    { 13, "modify", "Modify Order", true, modifyCommand },
+    { 14, "rollover", "End-of-Day Rollover", true, rolloverCommand },
+    { 15, "schedule", "TakeAway Scheduling", true, schedulingCommand },
+    { 16, "exit", "Exit", false, exitCommand },
+};
+constexpr size_t commandCount = sizeof(commandTable) / sizeof(commandTable[0]);
+
+constexpr bool commandsNumberedInOrder() {
+    for (size_t i = 0; i < commandCount; ++i)
+        if (commandTable[i].number != static_cast<int>(i) + 1) return false;
+    return true;
+}
+static_assert(commandsNumberedInOrder(), "commandTable must be numbered 1..N in order");
+
+template <typename Role>
+constexpr bool commandAllowed(const CommandDescriptor& c) { return Role::canMutate || !c.mutating; }
+
+// Slot 0 catches every out-of-range number.
+template <typename Role>
+constexpr array<CommandHandler, commandCount + 1> buildDispatchTable() {
+    array<CommandHandler, commandCount + 1> table{};
+    table[0] = invalidCommand;
+    for (size_t i = 0; i < commandCount; ++i)
+        table[i + 1] = commandAllowed<Role>(commandTable[i]) ? commandTable[i].handler : rejectCommand;
+    return table;
+}
+
+template <typename Role>
+inline constexpr array<CommandHandler, commandCount + 1> dispatchTable = buildDispatchTable<Role>();
+
+static_assert(dispatchTable<GuestRole>[2] == rejectCommand, "Guests must not place orders");
+static_assert(dispatchTable<AdminRole>[2] == placeTakeAwayCommand, "Admins may place orders");
+
+// Accepts either the command number or its keyword; 0 when unknown.
+int commandNumber(const string& token) {
+    if (!token.empty() && all_of(token.begin(), token.end(), [](unsigned char ch) { return isdigit(ch); }))
+        return token.size() < 4 ? stoi(token) : 0;
+    for (const auto& c : commandTable)
+        if (token == c.keyword) return c.number;
+    return 0;
+}
+
+// Runs one command; errors are reported to ctx.out and the session goes on.
+template <typename Role>
+void dispatch(int number, CommandContext& ctx) {
+    size_t slot = number > 0 && number <= static_cast<int>(commandCount) ? static_cast<size_t>(number) : 0;
+    try {
+        dispatchTable<Role>[slot](ctx);
+    }
+    catch (const exception& e) {
+        ctx.fail(e);
+    }
+}
+
+template <typename Role>
+void printCommandMenu(CommandContext& ctx) {
+    ctx.out << ctx.color(CYAN) << "\n==== Welcome! What would you like to do? ====\n" << ctx.color(RESET);
+    ctx.pause();
+    for (const auto& c : commandTable) {
+        if (!commandAllowed<Role>(c)) continue;
+        ctx.out << ctx.color(c.handler == exitCommand ? RED : YELLOW) << c.number << ". " << c.label << "\n" << ctx.color(RESET);
+    }
+    ctx.out << ctx.color(CYAN) << "Choice: " << ctx.color(RESET);
+    ctx.pause();
+}
+
+// Line protocol for non-console front ends: "<number|keyword> [args...]".
+template <typename Role>
+bool executeCommandLine(Restaurant& restaurant, EventManager& events, const string& line, ostream& out) {
+    istringstream in(line);
+    string token;
+    if (!(in >> token)) return true;
+    CommandContext ctx{ restaurant, events, in, out, false };
+    dispatch<Role>(commandNumber(token), ctx);
+    return ctx.running;
+}
+
+template <typename Role>
+void runCommandLoop(CommandContext& ctx) {
+    ctx.out << Role::dashboard;
+    string token;
+    while (ctx.running) {
+        if (ctx.interactive) printCommandMenu<Role>(ctx);
+        if (!(ctx.in >> token)) break;
+        dispatch<Role>(commandNumber(token), ctx);
+    }
+}
+
+// The only place the session's role is inspected at run time.
+void runSession(const Session& session, CommandContext& ctx) {
+    visit([&](auto role) { runCommandLoop<decltype(role)>(ctx); }, session);
+}
+
+// Batch driver: one command per line, arguments on the same line.
+void runBatch(const string& path, const Session& session) {
+    Restaurant restaurant;
+    EventManager manager;
+    manager.addObserver(new AnalyticsObserver());
+    manager.addObserver(new NotificationObserver());
+
+    ifstream file;
+    if (path != "-") {
+        file.open(path);
+        if (!file) throw runtime_error("Cannot open batch file " + path);
+    }
+    istream& in = path == "-" ? cin : file;
+
+    Logger::getInstance().log(LogEvent::SystemStarted);
+    string line;
+    visit([&](auto role) {
+        using Role = decltype(role);
+        cout << Role::dashboard;
+        while (getline(in, line))
+            if (!executeCommandLine<Role>(restaurant, manager, line, cout)) break;
+        }, session);
+    Logger::getInstance().log(LogEvent::SystemClosed);
+}
+
+// ===== Pricing Self-Check =====
+// Run with --pricing-selfcheck: prices random orders against random rule sets
+// and compares the compiled engine (single and batch) with evaluating every
+// rule directly. Small sets use the flat table, large ones the bitset fallback.
+bool checkPricingMode(mt19937& rng, bool large, int ruleSets, int orders) {
+    const vector<int> prices = { 0, 250, 450, 800, 600, 150 };
+    auto pick = [&](int lo, int hi) { return uniform_int_distribution<int>(lo, hi)(rng); };
+    size_t mismatches = 0, wrongMode = 0;
+    for (int set = 0; set < ruleSets; ++set) {
+        vector<PricingRule> rules(large ? pick(100, 160) : pick(1, 6));
+        for (auto& r : rules) {
+            if (pick(0, 1)) { r.minAge = pick(0, 150); r.maxAge = r.minAge + pick(0, 60); }
+            if (!pick(0, 2)) r.typeMask = static_cast<uint8_t>(pick(1, 2));
+            if (!pick(0, 2)) r.item = pick(1, 5);
+            if (pick(0, 1)) { r.minQty = pick(1, 60); r.maxQty = r.minQty + pick(0, 40); }
+            if (pick(0, 1)) { r.fromMinute = pick(0, 1439); r.toMinute = pick(0, 1439); }
+            r.percent = pick(-20, 20);
+            r.flat = pick(0, 2) ? 0 : pick(0, 99);
         }
+        PricingEngine engine;
+        engine.setBasePrices(prices);
+        engine.setRules(rules);
+        engine.compile();
+        if (engine.usesFlatTable() == large) ++wrongMode;
 
-        else if (ch == 10) {
-            cout << YELLOW << "Earnings: Rs. " << restaurant.getTotalEarnings() << RESET << endl;
-            std::this_thread::sleep_for(std::chrono::milliseconds(1000));
+        OrderBatch batch;
+        vector<double> single;
+        for (int k = 0; k < orders; ++k) {
+            int item = pick(1, 5), qty = pick(1, 110), age = pick(0, 220), minute = pick(0, 1439);
+            OrderType type = static_cast<OrderType>(pick(0, 1));
+            double mul = 1, add = 0;
+            for (const auto& r : rules) {
+                if (!r.matches(age, type, item, qty, minute)) continue;
+                mul *= 1.0 + r.percent / 100.0;
+                add += r.flat;
+            }
+            double expected = max(0.0, prices[item] * qty * mul + add);
+            double got = engine.price(item, qty, age, type, minute);
+            if (fabs(got - expected) > 1e-6 * max(1.0, expected)) ++mismatches;
+            batch.add(item, qty, age, type, minute);
+            single.push_back(got);
         }
+        vector<double> batched;
+        engine.priceBatch(batch, batched);
+        for (size_t k = 0; k < batched.size(); ++k)
+            if (batched[k] != single[k]) ++mismatches;
+    }
+    cout << (large ? "Bitset fallback" : "Flat table     ") << ": " << ruleSets << " rule sets, "
+        << ruleSets * orders << " orders, " << mismatches << " mismatches";
+    if (wrongMode) cout << ", " << wrongMode << " sets compiled in the other mode";
+    cout << endl;
+    return mismatches == 0 && wrongMode == 0;
+}
 
-        else if (ch == 11) {
-            string name;
-            cout << CYAN << "Enter customer name to search: " << RESET;
-            std::this_thread::sleep_for(std::chrono::milliseconds(1000));
-            cin >> name;
-            restaurant.searchServedOrderByName(name);
-            Logger::getInstance().log("Searched for served order: " + name);
-            std::this_thread::sleep_for(std::chrono::milliseconds(1000));
+bool runPricingSelfCheck() {
+    mt19937 rng(2024);
+    bool flatOk = checkPricingMode(rng, false, 40, 2000);
+    bool bitsetOk = checkPricingMode(rng, true, 10, 2000);
+    return flatOk && bitsetOk;
+}
+
+// ===== Allocation Report =====
+// Build with TRACK_ALLOCATIONS defined and run with --alloc-report N to count
+// heap allocations across N order lifecycles (place -> serve -> served tree).
+#ifdef TRACK_ALLOCATIONS
+static atomic<size_t> allocationCount{ 0 };
+
+// GCC pairs the inlined free() with the library's operator new and warns about
+// a mismatch; every form below is replaced together, so the pairing is sound.
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+void* operator new(size_t size) {
+    allocationCount.fetch_add(1, memory_order_relaxed);
+    if (void* p = malloc(size ? size : 1)) return p;
+    throw bad_alloc();
+}
+void* operator new[](size_t size) { return operator new(size); }
+void operator delete(void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { operator delete(p); }
+void operator delete[](void* p) noexcept { operator delete(p); }
+void operator delete[](void* p, size_t) noexcept { operator delete(p); }
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+#endif
+
+void runAllocationReport(int orders) {
+#ifndef TRACK_ALLOCATIONS
+    (void)orders;
+    cout << "Rebuild with TRACK_ALLOCATIONS defined to count heap allocations.\n";
+#else
+    Restaurant restaurant("alloc-report");
+
+    vector<string> names;
+    names.reserve(orders);
+    for (int i = 0; i < orders; ++i) names.push_back("C" + to_string(i));
+
+    size_t before = allocationCount.load();
+    for (int i = 0; i < orders; ++i) {
+        if (i % 2) restaurant.placeDineInOrder(move(names[i]), 1 + i % 5, 1 + i % 3, 20 + i % 50, 1 + i % 10);
+        else restaurant.placeTakeAwayOrder(move(names[i]), 1 + i % 5, 1 + i % 3, 20 + i % 50);
+        if (i % 16 == 15) restaurant.serveAllOrders([](const Customer&, int) {});
+    }
+    restaurant.serveAllOrders([](const Customer&, int) {});
+    size_t used = allocationCount.load() - before;
+
+    cout << "Orders: " << orders << "\nHeap allocations: " << used
+        << "\nAllocations per order: " << static_cast<double>(used) / orders << endl;
+#endif
+}
+
+
+// Parses a positive count from the command line.
+int parseCount(const string& text, const char* what) {
+    size_t used = 0;
+    unsigned long value = 0;
+    try {
+        value = stoul(text, &used);
+    }
+    catch (const exception&) {
+        used = 0;
+    }
+    if (used == 0 || used != text.size() || value < 1 || value > static_cast<unsigned long>(INT_MAX))
+        throw invalid_argument(string(what) + " must be a positive number, got \"" + text + "\"");
+    return static_cast<int>(value);
+}
+
+int main(int argc, char** argv)
+{
+    if (argc > 2 && string(argv[1]) == "--alloc-report") {
+        try {
+            runAllocationReport(parseCount(argv[2], "Order count"));
+        }
+        catch (const exception& e) {
+            cerr << e.what() << "\nUsage: --alloc-report <orders>" << endl;
+            return 1;
         }
+        Logger::shutdown();
+        return 0;
+    }
+    if (argc > 1 && string(argv[1]) == "--pricing-selfcheck") {
+        bool ok = runPricingSelfCheck();
+        cout << (ok ? "Pricing self-check passed" : "Pricing self-check FAILED") << endl;
+        return ok ? 0 : 1;
+    }
+    if (argc > 1 && string(argv[1]) == "--replay") {
+        try {
+            runReplay(argc > 2 ? argv[2] : "");
+        }
+        catch (const exception& e) {
+            cerr << e.what() << endl;
+            Logger::shutdown();
+            return 1;
+        }
+        Logger::shutdown();
+        return 0;
+    }
+    if (argc > 2 && string(argv[1]) == "--branches") {
+        try {
+            runBranchBenchmark(parseCount(argv[2], "Branch count"), argc > 3 ? parseCount(argv[3], "Orders per branch") : 100000);
+        }
+        catch (const exception& e) {
+            cerr << e.what() << "\nUsage: --branches <count> [orders per branch]" << endl;
+            Logger::shutdown();
+            return 1;
+        }
+        Logger::shutdown();
+        return 0;
+    }
 
-        else if (ch == 12) {
-            run = false;
+    if (argc > 2 && string(argv[1]) == "--batch") {
+        Session session = GuestRole();
+        if (argc > 3 && string(argv[3]) == "admin") session = AdminRole();
+        try {
+            runBatch(argv[2], session);
+        }
+        catch (const exception& e) {
+            cerr << e.what() << endl;
+            Logger::shutdown();
+            return 1;
         }
+        Logger::shutdown();
+        return 0;
+    }
 
-        else {
-            cout << RED << "Invalid option" << RESET << endl;
-            std::this_thread::sleep_for(std::chrono::milliseconds(1000));
+    Logger::getInstance().log(LogEvent::SystemStarted);
+    Restaurant restaurant;
+    EventManager manager;
+    manager.addObserver(new AnalyticsObserver());
+    manager.addObserver(new NotificationObserver());
+
+    cout << CYAN << "User Type (1 = Admin, 2 = Guest): " << RESET;
+    std::this_thread::sleep_for(std::chrono::milliseconds(1000));
+    int type = 2;
+    while (!(cin >> type) || (type != 1 && type != 2)) {
+        if (cin.eof()) {
+            type = 2;
+            break;
         }
+        cin.clear();
+        cin.ignore(numeric_limits<streamsize>::max(), '\n');
+        cout << RED << "Please enter 1 or 2: " << RESET;
     }
+    Session session = GuestRole();
+    if (type == 1) session = AdminRole();
 
-    Logger::getInstance().log("System Closed");
+    CommandContext ctx{ restaurant, manager, cin, cout, true };
+    runSession(session, ctx);
+
+    Logger::getInstance().log(LogEvent::SystemClosed);
+    Logger::shutdown();
     return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,348 @@
+#pragma once
+// ServedArchive.h
+#ifndef SERVED_ARCHIVE_H
+#define SERVED_ARCHIVE_H
+
+#include <cstdint>
+#include <cstring>
+#include <cstdio>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory>
+#include <fstream>
+#include <filesystem>
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
+
+// ===== Archive Segment =====
+// One day's served orders frozen into flat, name-sorted columns. Names live in a
+// single character blob addressed by offsets, item names in a small dictionary,
+// so a segment costs a few dozen bytes per order and is searched by bisection.
+class ServedSegment {
+    std::string day;
+    double earnings = 0;
+    std::vector<std::string> items;
+    std::string names;
+    std::vector<uint32_t> nameOffset{ 0 };
+    std::vector<uint16_t> itemId;
+    std::vector<uint8_t> type;
+    std::vector<int32_t> quantity, age;
+    std::vector<double> bill;
+
+    template <typename T>
+    static void put(std::ofstream& out, const T& v) { out.write(reinterpret_cast<const char*>(&v), sizeof(T)); }
+    template <typename T>
+    static void putArray(std::ofstream& out, const std::vector<T>& v) {
+        out.write(reinterpret_cast<const char*>(v.data()), v.size() * sizeof(T));
+    }
+    template <typename T>
+    static bool get(std::ifstream& in, T& v) { return static_cast<bool>(in.read(reinterpret_cast<char*>(&v), sizeof(T))); }
+    template <typename T>
+    static bool getArray(std::ifstream& in, std::vector<T>& v, size_t n) {
+        v.resize(n);
+        return static_cast<bool>(in.read(reinterpret_cast<char*>(v.data()), n * sizeof(T)));
+    }
+    static bool getString(std::ifstream& in, std::string& s) {
+        uint16_t len;
+        if (!get(in, len)) return false;
+        s.resize(len);
+        return static_cast<bool>(in.read(&s[0], len));
+    }
+
+    static bool readHeader(std::ifstream& in, uint32_t& count, double& earnings, std::string& day) {
+        char magic[4];
+        uint32_t version;
+        return in.read(magic, 4) && std::memcmp(magic, "RSEG", 4) == 0
+            && get(in, version) && version == 1
+            && get(in, count) && get(in, earnings) && getString(in, day);
+    }
+
+public:
+    ServedSegment() = default;
+    ServedSegment(std::string dayLabel, double dayEarnings) : day(std::move(dayLabel)), earnings(dayEarnings) {}
+
+    // Rows must be appended in ascending name order.
+    void append(std::string_view name, const std::string& item, uint8_t orderType, int qty, int customerAge, double amount) {
+        auto it = std::find(items.begin(), items.end(), item);
+        if (it == items.end()) it = items.insert(items.end(), item);
+        names.append(name.data(), name.size());
+        nameOffset.push_back(static_cast<uint32_t>(names.size()));
+        itemId.push_back(static_cast<uint16_t>(it - items.begin()));
+        type.push_back(orderType);
+        quantity.push_back(qty);
+        age.push_back(customerAge);
+        bill.push_back(amount);
+    }
+
+    void reserve(size_t n) {
+        nameOffset.reserve(n + 1);
+        itemId.reserve(n);
+        type.reserve(n);
+        quantity.reserve(n);
+        age.reserve(n);
+        bill.reserve(n);
+    }
+
+    size_t size() const { return bill.size(); }
+    const std::string& getDay() const { return day; }
+    double getEarnings() const { return earnings; }
+
+    std::string_view nameAt(size_t i) const {
+        return std::string_view(names).substr(nameOffset[i], nameOffset[i + 1] - nameOffset[i]);
+    }
+    const std::string& itemAt(size_t i) const { return items[itemId[i]]; }
+    uint8_t typeAt(size_t i) const { return type[i]; }
+    int quantityAt(size_t i) const { return quantity[i]; }
+    int ageAt(size_t i) const { return age[i]; }
+    double billAt(size_t i) const { return bill[i]; }
+
+    // Index of the row for name, or -1.
+    long find(std::string_view name) const {
+        size_t lo = 0, hi = size();
+        while (lo < hi) {
+            size_t mid = (lo + hi) / 2;
+            if (nameAt(mid) < name) lo = mid + 1;
+            else hi = mid;
+        }
+        return lo < size() && nameAt(lo) == name ? static_cast<long>(lo) : -1;
+    }
+
+    // Never replaces an existing file: archived days are immutable.
+    void save(const std::string& path) const {
+        if (std::filesystem::exists(path)) throw std::runtime_error("Archive segment already exists: " + path);
+        std::string tmp = path + ".tmp";
+        {
+            std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+            out.write("RSEG", 4);
+            put(out, uint32_t(1));
+            put(out, static_cast<uint32_t>(size()));
+            put(out, earnings);
+            put(out, static_cast<uint16_t>(day.size()));
+            out.write(day.data(), day.size());
+            put(out, static_cast<uint16_t>(items.size()));
+            for (const auto& item : items) {
+                put(out, static_cast<uint16_t>(item.size()));
+                out.write(item.data(), item.size());
+            }
+            put(out, static_cast<uint32_t>(names.size()));
+            out.write(names.data(), names.size());
+            putArray(out, nameOffset);
+            putArray(out, itemId);
+            putArray(out, type);
+            putArray(out, quantity);
+            putArray(out, age);
+            putArray(out, bill);
+            if (!out) throw std::runtime_error("Failed to write archive segment " + path);
+        }
+        std::filesystem::rename(tmp, path);
+    }
+
+    static std::unique_ptr<ServedSegment> load(const std::string& path) {
+        std::ifstream in(path, std::ios::binary);
+        auto seg = std::make_unique<ServedSegment>();
+        uint32_t count, nameBytes;
+        uint16_t itemCount;
+        if (!readHeader(in, count, seg->earnings, seg->day) || !get(in, itemCount))
+            throw std::runtime_error("Corrupt archive segment " + path);
+        seg->items.resize(itemCount);
+        for (auto& item : seg->items)
+            if (!getString(in, item)) throw std::runtime_error("Corrupt archive segment " + path);
+        if (!get(in, nameBytes)) throw std::runtime_error("Corrupt archive segment " + path);
+        seg->names.resize(nameBytes);
+        in.read(&seg->names[0], nameBytes);
+        if (!getArray(in, seg->nameOffset, count + 1) || !getArray(in, seg->itemId, count)
+            || !getArray(in, seg->type, count) || !getArray(in, seg->quantity, count)
+            || !getArray(in, seg->age, count) || !getArray(in, seg->bill, count))
+            throw std::runtime_error("Corrupt archive segment " + path);
+        return seg;
+    }
+
+    // Bisects the name column on disk and returns the matching row as a one-row
+    // segment, or null. Reads O(log n) names instead of the whole day.
+    static std::unique_ptr<ServedSegment> findOnDisk(const std::string& path, std::string_view name) {
+        std::ifstream in(path, std::ios::binary);
+        auto seg = std::make_unique<ServedSegment>();
+        uint32_t count, nameBytes;
+        uint16_t itemCount;
+        if (!readHeader(in, count, seg->earnings, seg->day) || !get(in, itemCount))
+            throw std::runtime_error("Corrupt archive segment " + path);
+        std::vector<std::string> itemNames(itemCount);
+        for (auto& item : itemNames)
+            if (!getString(in, item)) throw std::runtime_error("Corrupt archive segment " + path);
+        if (!get(in, nameBytes)) throw std::runtime_error("Corrupt archive segment " + path);
+
+        // Column positions follow the layout written by save().
+        std::streamoff namesPos = in.tellg();
+        std::streamoff offsetPos = namesPos + nameBytes;
+        std::streamoff itemPos = offsetPos + static_cast<std::streamoff>(sizeof(uint32_t)) * (count + 1);
+        std::streamoff typePos = itemPos + static_cast<std::streamoff>(sizeof(uint16_t)) * count;
+        std::streamoff quantityPos = typePos + static_cast<std::streamoff>(sizeof(uint8_t)) * count;
+        std::streamoff agePos = quantityPos + static_cast<std::streamoff>(sizeof(int32_t)) * count;
+        std::streamoff billPos = agePos + static_cast<std::streamoff>(sizeof(int32_t)) * count;
+
+        auto readAt = [&](std::streamoff column, size_t row, auto& v) {
+            in.seekg(column + static_cast<std::streamoff>(sizeof(v) * row));
+            if (!get(in, v)) throw std::runtime_error("Corrupt archive segment " + path);
+        };
+        std::string probe;
+        auto nameAtRow = [&](size_t row) -> const std::string& {
+            uint32_t from, to;
+            readAt(offsetPos, row, from);
+            readAt(offsetPos, row + 1, to);
+            if (to < from || to > nameBytes) throw std::runtime_error("Corrupt archive segment " + path);
+            probe.resize(to - from);
+            in.seekg(namesPos + from);
+            if (!in.read(&probe[0], probe.size())) throw std::runtime_error("Corrupt archive segment " + path);
+            return probe;
+        };
+
+        size_t lo = 0, hi = count;
+        while (lo < hi) {
+            size_t mid = (lo + hi) / 2;
+            if (std::string_view(nameAtRow(mid)) < name) lo = mid + 1;
+            else hi = mid;
+        }
+        if (lo >= count || nameAtRow(lo) != name) return nullptr;
+
+        uint16_t item;
+        uint8_t orderType;
+        int32_t qty, customerAge;
+        double amount;
+        readAt(itemPos, lo, item);
+        readAt(typePos, lo, orderType);
+        readAt(quantityPos, lo, qty);
+        readAt(agePos, lo, customerAge);
+        readAt(billPos, lo, amount);
+        if (item >= itemNames.size()) throw std::runtime_error("Corrupt archive segment " + path);
+        seg->append(name, itemNames[item], orderType, qty, customerAge, amount);
+        return seg;
+    }
+
+    static bool loadSummary(const std::string& path, uint32_t& count, double& earnings, std::string& day) {
+        std::ifstream in(path, std::ios::binary);
+        return readHeader(in, count, earnings, day);
+    }
+};
+
+// ===== Archive =====
+// The ordered list of frozen days. Only the newest few segments stay resident;
+// older ones are bisected on disk when a search reaches them.
+class ServedArchive {
+    struct Entry {
+        std::string path;
+        std::string day;
+        double earnings = 0;
+        uint32_t count = 0;
+        std::shared_ptr<const ServedSegment> resident;
+        mutable bool corrupt = false;
+    };
+
+    std::string directory;
+    size_t maxResident;
+    std::vector<Entry> entries;
+    std::vector<std::string> unreadable;
+    uint32_t lastSequence = 0;
+    double earnings = 0;
+
+    // Files are named served-NNNNNN-<day>.seg; 0 when the name does not match.
+    static uint32_t sequenceOf(const std::string& file) {
+        const std::string prefix = "served-";
+        if (file.compare(0, prefix.size(), prefix) != 0) return 0;
+        uint32_t seq = 0;
+        for (size_t i = prefix.size(); i < file.size() && file[i] >= '0' && file[i] <= '9'; ++i)
+            seq = seq * 10 + static_cast<uint32_t>(file[i] - '0');
+        return seq;
+    }
+
+    void evict() {
+        size_t resident = 0;
+        for (size_t i = entries.size(); i-- > 0;)
+            if (entries[i].resident && ++resident > maxResident)
+                entries[i].resident.reset();
+    }
+
+public:
+    explicit ServedArchive(std::string dir = "archive", size_t residentSegments = 7)
+        : directory(std::move(dir)), maxResident(residentSegments) {
+        namespace fs = std::filesystem;
+        std::error_code ec;
+        std::vector<std::string> paths;
+        for (const auto& entry : fs::directory_iterator(directory, ec)) {
+            if (entry.path().extension() != ".seg") continue;
+            paths.push_back(entry.path().string());
+            // Unreadable segments still hold their number, so add() never reuses it.
+            lastSequence = std::max(lastSequence, sequenceOf(entry.path().filename().string()));
+        }
+        std::sort(paths.begin(), paths.end());
+        for (const auto& path : paths) {
+            Entry e;
+            e.path = path;
+            if (!ServedSegment::loadSummary(path, e.count, e.earnings, e.day)) {
+                unreadable.push_back(path);
+                continue;
+            }
+            earnings += e.earnings;
+            entries.push_back(std::move(e));
+        }
+    }
+
+    // Writes the segment to disk and keeps it resident as the newest day.
+    void add(ServedSegment segment) {
+        std::filesystem::create_directories(directory);
+        Entry e;
+        do {
+            char name[32];
+            std::snprintf(name, sizeof(name), "served-%06u-", ++lastSequence);
+            e.path = (std::filesystem::path(directory) / (name + segment.getDay() + ".seg")).string();
+        } while (std::filesystem::exists(e.path));
+        segment.save(e.path);
+        e.day = segment.getDay();
+        e.earnings = segment.getEarnings();
+        e.count = static_cast<uint32_t>(segment.size());
+        e.resident = std::make_shared<const ServedSegment>(std::move(segment));
+        earnings += e.earnings;
+        entries.push_back(std::move(e));
+        evict();
+    }
+
+    // Visits every archived row for name, newest day first. A segment that
+    // turns out to be corrupt is passed to skipped once and left out from then
+    // on, so one bad day never hides the others.
+    void findAll(std::string_view name, const std::function<void(const ServedSegment&, size_t)>& visit,
+                 const std::function<void(const std::string&)>& skipped) const {
+        for (size_t i = entries.size(); i-- > 0;) {
+            const Entry& e = entries[i];
+            if (e.corrupt) continue;
+            if (const auto& seg = e.resident) {
+                long row = seg->find(name);
+                if (row >= 0) visit(*seg, static_cast<size_t>(row));
+                continue;
+            }
+            std::unique_ptr<ServedSegment> hit;
+            try {
+                hit = ServedSegment::findOnDisk(e.path, name);
+            }
+            catch (const std::runtime_error&) {
+                e.corrupt = true;
+                skipped(e.path);
+                continue;
+            }
+            if (hit) visit(*hit, 0);
+        }
+    }
+
+    // Segments the constructor could not read; they are left out of every search.
+    const std::vector<std::string>& unreadableSegments() const { return unreadable; }
+
+    double getEarnings() const { return earnings; }
+    size_t segmentCount() const { return entries.size(); }
+    size_t orderCount() const {
+        size_t n = 0;
+        for (const auto& e : entries) n += e.count;
+        return n;
+    }
+};
+
+#endif
@@ -0,0 +1,39 @@
+#pragma once
+// ThreadAffinity.h
+#ifndef THREAD_AFFINITY_H
+#define THREAD_AFFINITY_H
+
+#include <thread>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+inline unsigned hardwareCores() {
+    unsigned n = std::thread::hardware_concurrency();
+    return n ? n : 1;
+}
+
+// Pins the calling thread to one core; returns false where that is not supported.
+inline bool pinThisThreadToCore(unsigned core) {
+    core %= hardwareCores();
+#ifdef _WIN32
+    return SetThreadAffinityMask(GetCurrentThread(), DWORD_PTR(1) << core) != 0;
+#elif defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(core, &set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+    (void)core;
+    return false;
+#endif
+}
+
+#endif